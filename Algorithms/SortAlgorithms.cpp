@@ -394,4 +394,75 @@ public:
         // Free the memory allocated for the temporary array
         delete[] output;
     }
+
+    /**
+     * Byte-wise LSD radix sort of any element type by an unsigned 64-bit key.
+     * The counts of all 8 bytes are gathered in one pass, and passes over a byte that
+     * is the same in every key are skipped, so small keys only cost one or two passes.
+     * The sort is stable.
+     *
+     * @attention The array is sorted and kept in the same pointer.
+     * @tparam KeyOf Callable mapping an element to its unsigned long long key.
+     * @param arr Pointer to the array to be sorted.
+     * @param size The number of elements in the array.
+     * @param keyOf The key function (smaller keys come first).
+     */
+    template<typename KeyOf>
+    void radixSortByKey(T *arr, int size, KeyOf keyOf) {
+
+        if (size < 2) {
+            return;
+        }
+
+        // count every byte of every key at once
+        int *count = new int[8 * 256]();
+        for (int j = 0; j < size; j++) {
+            unsigned long long key = keyOf(arr[j]);
+            for (int b = 0; b < 8; b++) {
+                count[b * 256 + ((key >> (8 * b)) & 255)]++;
+            }
+        }
+
+        T *output = new T[size];
+        T *from = arr, *to = output;
+
+        for (int b = 0; b < 8; b++) {
+            int *byteCount = count + b * 256;
+
+            // skip the pass if every key has the same byte here
+            bool trivial = false;
+            for (int d = 0; d < 256; d++) {
+                if (byteCount[d] != 0) {
+                    trivial = (byteCount[d] == size);
+                    break;
+                }
+            }
+            if (trivial) {
+                continue;
+            }
+
+            // turn the counts into starting positions
+            int position = 0;
+            for (int d = 0; d < 256; d++) {
+                int c = byteCount[d];
+                byteCount[d] = position;
+                position += c;
+            }
+
+            for (int j = 0; j < size; j++) {
+                to[byteCount[(keyOf(from[j]) >> (8 * b)) & 255]++] = from[j];
+            }
+            swap(from, to);
+        }
+
+        // the sorted elements may have ended up in the temporary array
+        if (from != arr) {
+            for (int j = 0; j < size; j++) {
+                arr[j] = from[j];
+            }
+        }
+
+        delete[] output;
+        delete[] count;
+    }
 };
@@ -2,7 +2,7 @@
     Author: Seif Ibrahim
     Description: Fenwick Tree Data Strcture implementation
 
-    Last Updated: 18/7/2023
+    Last Updated: 19/10/2026
 
     Github: Seif-Ibrahim1
 
@@ -10,12 +10,29 @@
 
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 using namespace std;
 
-// FenwickTree class for efficient range sum queries and point updates
+// FenwickTree class for efficient range sum queries and point updates.
+// T can be any type with +, - and a zero value T() (integers, doubles, modular integers).
+template <typename T = long>
 class FenwickTree {
-    long* tree;     // Array storing the Fenwick tree
+    T* tree;        // Array storing the Fenwick tree
     int size;       // Size of the Fenwick tree
 
     // Function to get the least significant bit
@@ -27,27 +44,27 @@ public:
     // Constructor to initialize the Fenwick tree with a given size
     FenwickTree(int _size) {
         size = _size + 1;
-        tree = new long[size];
+        tree = new T[size];
 
         for (int i = 0; i < size; i++) {
-            tree[i] = 0; 
+            tree[i] = T();
         }
     }
 
-    // Constructor to initialize the Fenwick tree with an existing array
-    FenwickTree(long other[], int _size) {
-        size = _size;
-        tree = new long[size + 1];
+    // Constructor to initialize the Fenwick tree with an existing array in O(n)
+    FenwickTree(const T other[], int _size) {
+        size = _size + 1;
+        tree = new T[size];
 
-        for (int i = 1; i <= _size; i++) {
-            tree[i] = 0;
+        tree[0] = T();
+        for (int i = 1; i < size; i++) {
             tree[i] = other[i - 1];
         }
 
         for (int i = 1; i < size; i++) {
             int j = i + lsb(i);
-            if (j <= size) {
-                tree[j] += tree[i];
+            if (j < size) {
+                tree[j] = tree[j] + tree[i];
             }
         }
     }
@@ -57,11 +74,19 @@ public:
         delete[] tree;
     }
 
+    FenwickTree(const FenwickTree&) = delete;
+    FenwickTree& operator=(const FenwickTree&) = delete;
+
+    // Function to get the number of elements
+    int length() {
+        return size - 1;
+    }
+
     // Function to compute the prefix sum from index 1 to i
-    long prefixSum(int i) {
-        long sum = 0L;
+    T prefixSum(int i) {
+        T sum = T();
         while (i != 0) {
-            sum += tree[i];
+            sum = sum + tree[i];
             i &= ~lsb(i);
         }
 
@@ -69,27 +94,1225 @@ public:
     }
 
     // Function to compute the sum of elements in the range [i, j]
-    long sum(int i, int j) {
+    T sum(int i, int j) {
         return prefixSum(j) - prefixSum(i - 1);
     }
 
+    // Function to get the element at index i: tree[i] covers (i - lsb(i), i], so subtract
+    // the nodes covering (i - lsb(i), i - 1], which is the path down from i - 1
+    T get(int i) {
+        T value = tree[i];
+        int stop = i - lsb(i);
+        for (int j = i - 1; j > stop; j &= ~lsb(j)) {
+            value = value - tree[j];
+        }
+
+        return value;
+    }
+
     // Function to add a value k to the element at index i
-    void add(int i, long k) {
+    void add(int i, T k) {
         while (i < size) {
-            tree[i] += k;
+            tree[i] = tree[i] + k;
             i += lsb(i);
         }
     }
 
     // Function to set the element at index i to a value k
-    void set(int i, long k) {
-        long value = sum(i, i);
-        add(i, k - value);
+    void set(int i, T k) {
+        add(i, k - get(i));
+    }
+
+    /**
+     * Finds the first index whose prefix sum reaches a target by binary lifting, in O(log n).
+     * All elements must be non-negative, so the prefix sums are non-decreasing; with counts as
+     * elements this selects the element of a given rank, with weights it samples by weight.
+     *
+     * @param prefix The target prefix sum.
+     * @return The smallest i with prefixSum(i) >= prefix, or length() + 1 if there is none.
+     */
+    int lowerBound(T prefix) {
+        if (!(T() < prefix)) {
+            return 1;
+        }
+
+        int position = 0;
+        int step = 1;
+        while (2 * step < size) {
+            step *= 2;
+        }
+
+        // Descend from the largest power of two, keeping the prefix before position below target
+        for (; step > 0; step /= 2) {
+            int next = position + step;
+            if (next < size && tree[next] < prefix) {
+                position = next;
+                prefix = prefix - tree[next];
+            }
+        }
+
+        return position + 1;
+    }
+};
+
+// BlockedFenwickTree class: the FenwickTree API over a two-level layout for arrays much larger
+// than the cache. The elements are cut into blocks of BLOCK (8 longs fill one cache line);
+// a block stores the running sums of its own elements, and a top FenwickTree, BLOCK times
+// smaller than the array, keeps the block totals. A prefix query reads one entry of one block
+// plus the top tree, so the only cache line touched in the big array is the element's own; the
+// flat layout instead strides across the whole array by powers of two, every hop a separate line
+// mapping to the same sets. The layout only pays off for queries on arrays larger than the
+// last-level cache: an add still rewrites a whole block line and walks the top tree, so it costs
+// about what a flat add does, and below the cache size the flat tree is as fast or faster.
+template <typename T = long, int BLOCK = 8>
+class BlockedFenwickTree {
+    // Running sums of one block, starting on a cache line
+    struct alignas(64) Block {
+        T sums[BLOCK];
+    };
+
+    Block* blocks;          // sums[j] of block b is the sum of elements b * BLOCK + 1 .. b * BLOCK + j + 1
+    FenwickTree<T> top;     // Fenwick tree over the block totals
+    int size;               // Number of elements
+
+    // Function to get the number of blocks for a number of elements
+    static int blocksFor(int n) {
+        return (n + BLOCK - 1) / BLOCK;
+    }
+
+public:
+    // Constructor to initialize the tree with a given size
+    BlockedFenwickTree(int _size) : top(blocksFor(_size)) {
+        size = _size;
+        blocks = new Block[blocksFor(size)];
+
+        for (int b = 0; b < blocksFor(size); b++) {
+            for (int j = 0; j < BLOCK; j++) {
+                blocks[b].sums[j] = T();
+            }
+        }
+    }
+
+    // Constructor to initialize the tree with an existing array in O(n)
+    BlockedFenwickTree(const T other[], int _size) : BlockedFenwickTree(_size) {
+        for (int b = 0; b < blocksFor(size); b++) {
+            T running = T();
+            for (int j = 0; j < BLOCK; j++) {
+                if (b * BLOCK + j < size) {
+                    running = running + other[b * BLOCK + j];
+                }
+                blocks[b].sums[j] = running;
+            }
+            top.add(b + 1, running);
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~BlockedFenwickTree() {
+        delete[] blocks;
+    }
+
+    BlockedFenwickTree(const BlockedFenwickTree&) = delete;
+    BlockedFenwickTree& operator=(const BlockedFenwickTree&) = delete;
+
+    // Function to get the number of elements
+    int length() {
+        return size;
+    }
+
+    // Function to compute the prefix sum from index 1 to i
+    T prefixSum(int i) {
+        if (i == 0) {
+            return T();
+        }
+
+        int b = (i - 1) / BLOCK;
+        return top.prefixSum(b) + blocks[b].sums[(i - 1) % BLOCK];
+    }
+
+    // Function to compute the sum of elements in the range [i, j]
+    T sum(int i, int j) {
+        return prefixSum(j) - prefixSum(i - 1);
+    }
+
+    // Function to get the element at index i
+    T get(int i) {
+        int b = (i - 1) / BLOCK, j = (i - 1) % BLOCK;
+        return (j == 0) ? blocks[b].sums[0] : blocks[b].sums[j] - blocks[b].sums[j - 1];
+    }
+
+    // Function to add a value k to the element at index i. Every running sum of the block is
+    // rewritten, adding zero before the element, so the loop has a fixed trip count and no branch
+    void add(int i, T k) {
+        int b = (i - 1) / BLOCK, from = (i - 1) % BLOCK;
+        for (int j = 0; j < BLOCK; j++) {
+            blocks[b].sums[j] = blocks[b].sums[j] + ((j >= from) ? k : T());
+        }
+        top.add(b + 1, k);
+    }
+
+    // Function to set the element at index i to a value k
+    void set(int i, T k) {
+        add(i, k - get(i));
+    }
+
+    // Function to find the smallest i with prefixSum(i) >= prefix (non-negative elements),
+    // or length() + 1 if there is none: the top tree picks the block, a scan the element
+    int lowerBound(T prefix) {
+        if (!(T() < prefix)) {
+            return 1;
+        }
+
+        int b = top.lowerBound(prefix) - 1;
+        if (b >= blocksFor(size)) {
+            return size + 1;
+        }
+        T before = top.prefixSum(b);
+        int j = 0;
+        while (blocks[b].sums[j] + before < prefix) {
+            j++;
+        }
+        return b * BLOCK + j + 1;
+    }
+};
+
+// RangeFenwickTree class: range add and range sum with two Fenwick trees. Adding k to
+// [l, r] adds k to the slope at l and -k at r + 1 in the first tree, and the matching
+// offsets in the second, so that prefixSum(i) = slope(i) * i - offset(i).
+template <typename T = long>
+class RangeFenwickTree {
+    FenwickTree<T> slopes;      // Point updates of the per-element added value
+    FenwickTree<T> offsets;     // Corrections for the part of an update before its range
+
+public:
+    // Constructor to initialize the tree with a given size
+    RangeFenwickTree(int _size) : slopes(_size), offsets(_size) {
+    }
+
+    // Function to get the number of elements
+    int length() {
+        return slopes.length();
+    }
+
+    // Function to add a value k to every element in the range [l, r]
+    void rangeAdd(int l, int r, T k) {
+        slopes.add(l, k);
+        offsets.add(l, k * T(l - 1));
+        if (r + 1 <= length()) {
+            slopes.add(r + 1, T() - k);
+            offsets.add(r + 1, T() - k * T(r));
+        }
+    }
+
+    // Function to add a value k to the element at index i
+    void add(int i, T k) {
+        rangeAdd(i, i, k);
+    }
+
+    // Function to compute the prefix sum from index 1 to i
+    T prefixSum(int i) {
+        return slopes.prefixSum(i) * T(i) - offsets.prefixSum(i);
+    }
+
+    // Function to compute the sum of elements in the range [i, j]
+    T sum(int i, int j) {
+        return prefixSum(j) - prefixSum(i - 1);
+    }
+
+    // Function to get the element at index i
+    T get(int i) {
+        return slopes.prefixSum(i);
+    }
+};
+
+// FenwickTree2D class: point updates and rectangle sums over a rows x cols grid, with the
+// (rows + 1) x (cols + 1) tree stored contiguously in row-major order. Indices are 1-based.
+template <typename T = long>
+class FenwickTree2D {
+    T* tree;        // Row-major array storing the tree
+    int rows;       // Number of rows
+    int cols;       // Number of columns
+    int stride;     // Length of a stored row (cols + 1)
+
+    // Function to get the least significant bit
+    int lsb(int i) {
+        return i & -i;
+    }
+
+public:
+    // Constructor to initialize an all-zero tree
+    FenwickTree2D(int _rows, int _cols) {
+        rows = _rows;
+        cols = _cols;
+        stride = cols + 1;
+        tree = new T[(long long) (rows + 1) * stride];
+
+        for (long long i = 0; i < (long long) (rows + 1) * stride; i++) {
+            tree[i] = T();
+        }
+    }
+
+    // Constructor to build the tree from a row-major rows x cols array in O(rows * cols):
+    // first every row is built like a 1D tree, then whole rows are pushed to their parents
+    FenwickTree2D(const T other[], int _rows, int _cols) : FenwickTree2D(_rows, _cols) {
+        for (int r = 1; r <= rows; r++) {
+            T* row = tree + (long long) r * stride;
+            for (int c = 1; c <= cols; c++) {
+                row[c] = other[(long long) (r - 1) * cols + (c - 1)];
+            }
+            for (int c = 1; c <= cols; c++) {
+                int parent = c + lsb(c);
+                if (parent <= cols) {
+                    row[parent] = row[parent] + row[c];
+                }
+            }
+        }
+
+        for (int r = 1; r <= rows; r++) {
+            int parent = r + lsb(r);
+            if (parent <= rows) {
+                T* row = tree + (long long) r * stride;
+                T* parentRow = tree + (long long) parent * stride;
+                for (int c = 1; c <= cols; c++) {
+                    parentRow[c] = parentRow[c] + row[c];
+                }
+            }
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~FenwickTree2D() {
+        delete[] tree;
+    }
+
+    FenwickTree2D(const FenwickTree2D&) = delete;
+    FenwickTree2D& operator=(const FenwickTree2D&) = delete;
+
+    // Function to compute the sum of the rectangle [1, r] x [1, c]
+    T prefixSum(int r, int c) {
+        T sum = T();
+        for (int i = r; i != 0; i &= ~lsb(i)) {
+            T* row = tree + (long long) i * stride;
+            for (int j = c; j != 0; j &= ~lsb(j)) {
+                sum = sum + row[j];
+            }
+        }
+
+        return sum;
+    }
+
+    // Function to compute the sum of the rectangle [r1, r2] x [c1, c2]
+    T sum(int r1, int c1, int r2, int c2) {
+        return prefixSum(r2, c2) - prefixSum(r1 - 1, c2) - prefixSum(r2, c1 - 1) + prefixSum(r1 - 1, c1 - 1);
+    }
+
+    // Function to add a value k to the element at (r, c)
+    void add(int r, int c, T k) {
+        for (int i = r; i <= rows; i += lsb(i)) {
+            T* row = tree + (long long) i * stride;
+            for (int j = c; j <= cols; j += lsb(j)) {
+                row[j] = row[j] + k;
+            }
+        }
+    }
+};
+
+// SparseFenwickTree2D class: an offline 2D Fenwick tree for huge coordinate domains. The
+// points that will ever be updated are given up front. The x coordinates are compressed,
+// and every node of the outer tree keeps the sorted distinct y of the points it covers with
+// an inner Fenwick tree over just those, so memory is O(p log p) for p points whatever
+// the domain size. All nodes are packed into two flat arrays indexed by per-node offsets.
+template <typename T = long>
+class SparseFenwickTree2D {
+    vector<int> xs;             // Sorted distinct x coordinates (outer tree nodes 1..xs.size())
+    vector<int> offsets;        // Start of every node's run in ys / tree (node i is [offsets[i - 1], offsets[i]))
+    vector<int> ys;             // Sorted distinct y coordinates of every node
+    vector<T> tree;             // Inner Fenwick tree of every node, 1-based (entry k of node i is tree[offsets[i - 1] + k])
+
+    // Function to get the least significant bit
+    int lsb(int i) {
+        return i & -i;
+    }
+
+    // Function to build the node layout from the points
+    void layout(const vector<pair<int, int>>& points) {
+        for (auto& point : points) {
+            xs.push_back(point.first);
+        }
+        sort(xs.begin(), xs.end());
+        xs.erase(unique(xs.begin(), xs.end()), xs.end());
+
+        int m = (int) xs.size();
+        vector<vector<int>> nodeYs(m + 1);
+        for (auto& point : points) {
+            int x = (int) (lower_bound(xs.begin(), xs.end(), point.first) - xs.begin()) + 1;
+            for (int i = x; i <= m; i += lsb(i)) {
+                nodeYs[i].push_back(point.second);
+            }
+        }
+
+        offsets.assign(m + 1, 0);
+        for (int i = 1; i <= m; i++) {
+            sort(nodeYs[i].begin(), nodeYs[i].end());
+            nodeYs[i].erase(unique(nodeYs[i].begin(), nodeYs[i].end()), nodeYs[i].end());
+            offsets[i] = offsets[i - 1] + (int) nodeYs[i].size();
+        }
+        ys.reserve(offsets[m]);
+        for (int i = 1; i <= m; i++) {
+            ys.insert(ys.end(), nodeYs[i].begin(), nodeYs[i].end());
+        }
+        tree.assign(offsets[m] + 1, T());
+    }
+
+    // Function to get the 1-based position of y in the inner tree of node i, or 0 if absent
+    int positionOf(int i, int y) {
+        auto first = ys.begin() + offsets[i - 1], last = ys.begin() + offsets[i];
+        auto it = lower_bound(first, last, y);
+        return (it != last && *it == y) ? (int) (it - first) + 1 : 0;
+    }
+
+public:
+    /**
+     * Constructor for an all-zero tree over the given points.
+     *
+     * @param points Every (x, y) that add() will be called on; duplicates are fine.
+     */
+    SparseFenwickTree2D(const vector<pair<int, int>>& points) {
+        layout(points);
+    }
+
+    /**
+     * Constructor for a tree holding the given weighted points. The values are added to
+     * their nodes and every inner tree is then built in linear time, as in the 1D array
+     * constructor.
+     *
+     * @param points The (x, y) coordinates; duplicates add up.
+     * @param weights The value of every point.
+     */
+    SparseFenwickTree2D(const vector<pair<int, int>>& points, const vector<T>& weights) {
+        if (weights.size() != points.size()) {
+            throw invalid_argument("Every point needs a weight");
+        }
+        layout(points);
+
+        int m = (int) xs.size();
+        for (size_t p = 0; p < points.size(); p++) {
+            int x = (int) (lower_bound(xs.begin(), xs.end(), points[p].first) - xs.begin()) + 1;
+            T* inner = tree.data() + offsets[x - 1];
+            inner[positionOf(x, points[p].second)] = inner[positionOf(x, points[p].second)] + weights[p];
+        }
+
+        // The raw values only sit in each point's own node: build every inner tree, then push
+        // each node's raw values into its parent's node before building the parent
+        for (int i = 1; i <= m; i++) {
+            int length = offsets[i] - offsets[i - 1];
+            T* inner = tree.data() + offsets[i - 1];
+            int parent = i + lsb(i);
+            if (parent <= m) {
+                // ys of i are a subset of ys of parent: walk both sorted runs together
+                T* parentInner = tree.data() + offsets[parent - 1];
+                int q = 1;
+                for (int k = 1; k <= length; k++) {
+                    while (ys[offsets[parent - 1] + q - 1] != ys[offsets[i - 1] + k - 1]) {
+                        q++;
+                    }
+                    parentInner[q] = parentInner[q] + inner[k];
+                }
+            }
+            for (int k = 1; k <= length; k++) {
+                int up = k + lsb(k);
+                if (up <= length) {
+                    inner[up] = inner[up] + inner[k];
+                }
+            }
+        }
+    }
+
+    // Function to add a value k to the point (x, y), which must be one of the given points
+    void add(int x, int y, T k) {
+        auto it = lower_bound(xs.begin(), xs.end(), x);
+        int i = (int) (it - xs.begin()) + 1;
+        if (it == xs.end() || *it != x || positionOf(i, y) == 0) {
+            throw invalid_argument("Point was not given to the constructor");
+        }
+
+        int m = (int) xs.size();
+        for (; i <= m; i += lsb(i)) {
+            int length = offsets[i] - offsets[i - 1];
+            T* inner = tree.data() + offsets[i - 1];
+            for (int j = positionOf(i, y); j <= length; j += lsb(j)) {
+                inner[j] = inner[j] + k;
+            }
+        }
+    }
+
+    // Function to compute the sum of all points with px <= x and py <= y
+    T prefixSum(int x, int y) {
+        T sum = T();
+        int i = (int) (upper_bound(xs.begin(), xs.end(), x) - xs.begin());
+        for (; i != 0; i &= ~lsb(i)) {
+            auto first = ys.begin() + offsets[i - 1], last = ys.begin() + offsets[i];
+            T* inner = tree.data() + offsets[i - 1];
+            for (int j = (int) (upper_bound(first, last, y) - first); j != 0; j &= ~lsb(j)) {
+                sum = sum + inner[j];
+            }
+        }
+
+        return sum;
+    }
+
+    // Function to compute the sum of all points in [x1, x2] x [y1, y2]
+    T sum(int x1, int y1, int x2, int y2) {
+        return prefixSum(x2, y2) - prefixSum(x1 - 1, y2) - prefixSum(x2, y1 - 1) + prefixSum(x1 - 1, y1 - 1);
+    }
+};
+
+// ConcurrentFenwickTree class: a FenwickTree of integer counters that many threads may update
+// and query at once without a lock. add() does an atomic fetch_add on each node it touches;
+// prefixSum() reads the nodes with relaxed loads, so a query running alongside updates sees
+// each of them either entirely or not at all, but not necessarily all updates that finished
+// before it on other threads (it is exact once the writers are quiet).
+// With more than one shard, every thread adds into its own copy of the tree and queries sum
+// the copies, which removes write contention at the cost of slower reads.
+template <typename T = long>
+class ConcurrentFenwickTree {
+    static_assert(is_integral<T>::value, "ConcurrentFenwickTree needs an integer value type");
+
+    atomic<T>** shards; // Copies of the tree, each allocated on its own
+    int shardsCount;    // Number of copies
+    int size;           // Size of each Fenwick tree
+
+    // Function to get the least significant bit
+    int lsb(int i) {
+        return i & -i;
+    }
+
+    // Function to get the shard of the calling thread
+    int shardOfThread() {
+        static atomic<int> nextThread(0);
+        thread_local int threadIndex = nextThread.fetch_add(1);
+        return threadIndex % shardsCount;
+    }
+
+public:
+    // Constructor to initialize the tree with a given size and number of shards
+    ConcurrentFenwickTree(int _size, int _shards = 1) {
+        size = _size + 1;
+        shardsCount = max(1, _shards);
+        shards = new atomic<T>*[shardsCount];
+        for (int s = 0; s < shardsCount; s++) {
+            shards[s] = new atomic<T>[size];
+            for (int i = 0; i < size; i++) {
+                shards[s][i].store(0, memory_order_relaxed);
+            }
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~ConcurrentFenwickTree() {
+        for (int s = 0; s < shardsCount; s++) {
+            delete[] shards[s];
+        }
+        delete[] shards;
+    }
+
+    ConcurrentFenwickTree(const ConcurrentFenwickTree&) = delete;
+    ConcurrentFenwickTree& operator=(const ConcurrentFenwickTree&) = delete;
+
+    // Function to get the number of elements
+    int length() {
+        return size - 1;
+    }
+
+    // Function to compute the prefix sum from index 1 to i
+    T prefixSum(int i) {
+        T sum = 0;
+        for (int s = 0; s < shardsCount; s++) {
+            atomic<T>* tree = shards[s];
+            for (int j = i; j != 0; j &= ~lsb(j)) {
+                sum += tree[j].load(memory_order_relaxed);
+            }
+        }
+
+        return sum;
+    }
+
+    // Function to compute the sum of elements in the range [i, j]
+    T sum(int i, int j) {
+        return prefixSum(j) - prefixSum(i - 1);
+    }
+
+    // Function to add a value k to the element at index i
+    void add(int i, T k) {
+        atomic<T>* tree = shards[shardsCount == 1 ? 0 : shardOfThread()];
+        while (i < size) {
+            tree[i].fetch_add(k, memory_order_relaxed);
+            i += lsb(i);
+        }
+    }
+};
+
+// Monoids for LazySegmentTree: a value type, its identity and an associative combine.
+// A monoid whose combine also commutes says so with COMMUTATIVE, which lets a point add
+// combine the added value straight into every ancestor instead of recomputing them.
+template <typename T>
+struct SumMonoid {
+    typedef T Value;
+    static const bool COMMUTATIVE = true;
+    static T identity() { return T(); }
+    static T combine(const T& a, const T& b) { return a + b; }
+};
+
+template <typename T>
+struct MinMonoid {
+    typedef T Value;
+    static const bool COMMUTATIVE = true;
+    static T identity() { return numeric_limits<T>::max(); }
+    static T combine(const T& a, const T& b) { return b < a ? b : a; }
+};
+
+template <typename T>
+struct MaxMonoid {
+    typedef T Value;
+    static const bool COMMUTATIVE = true;
+    static T identity() { return numeric_limits<T>::lowest(); }
+    static T combine(const T& a, const T& b) { return a < b ? b : a; }
+};
+
+// Sum that also counts the elements, for updates whose effect on a sum depends on its length
+template <typename T>
+struct SumLength {
+    T sum;
+    int length;
+};
+
+template <typename T>
+struct SumLengthMonoid {
+    typedef SumLength<T> Value;
+    static const bool COMMUTATIVE = true;
+    static Value identity() { return Value{ T(), 0 }; }
+    static Value combine(const Value& a, const Value& b) { return Value{ a.sum + b.sum, a.length + b.length }; }
+};
+
+// Whether a monoid declares a commutative combine (monoids without COMMUTATIVE do not)
+template <typename Monoid, typename = void>
+struct isCommutative : false_type {
+};
+
+template <typename Monoid>
+struct isCommutative<Monoid, void_t<decltype(Monoid::COMMUTATIVE)>> : integral_constant<bool, Monoid::COMMUTATIVE> {
+};
+
+// Lazy tags for LazySegmentTree: an update type, the identity update, how an update changes a
+// combined value (apply) and how two updates chain (compose(f, g) = f after g)
+
+// No range updates: the tree stores no tags and never pushes
+struct NoTag {
+    struct Update {
+    };
+    static Update identity() { return Update(); }
+    template <typename V>
+    static V apply(const Update&, const V& value) { return value; }
+    static Update compose(const Update&, const Update&) { return Update(); }
+};
+
+// Add a constant to every element, for min / max values
+template <typename T>
+struct AddTag {
+    typedef T Update;
+    static T identity() { return T(); }
+    static T apply(const T& f, const T& value) { return value + f; }
+    static T compose(const T& f, const T& g) { return f + g; }
+};
+
+// Assign a constant to every element, for min / max values
+template <typename T>
+struct AssignTag {
+    struct Update {
+        bool assigned;
+        T value;
+    };
+    static Update identity() { return Update{ false, T() }; }
+    static T apply(const Update& f, const T& value) { return f.assigned ? f.value : value; }
+    static Update compose(const Update& f, const Update& g) { return f.assigned ? f : g; }
+};
+
+// Replace every element x by mul * x + add, for SumLength values
+template <typename T>
+struct AffineTag {
+    struct Update {
+        T mul;
+        T add;
+    };
+    static Update identity() { return Update{ T(1), T() }; }
+    static SumLength<T> apply(const Update& f, const SumLength<T>& value) {
+        return SumLength<T>{ f.mul * value.sum + f.add * T(value.length), value.length };
+    }
+    static Update compose(const Update& f, const Update& g) {
+        return Update{ f.mul * g.mul, f.mul * g.add + f.add };
+    }
+};
+
+// A node of the segment tree; without range updates it holds just the value
+template <typename V, typename U>
+struct SegmentNode {
+    V value;
+    U lazy;
+};
+
+template <typename V>
+struct SegmentNode<V, NoTag::Update> {
+    V value;
+};
+
+// Function to ask for transparent huge pages under the whole 2MB pages of an array. A tree walk
+// touches one node per level, and with 4KB pages the low levels miss the TLB as well as the cache.
+template <typename T>
+void adviseHugePages(T* array, size_t count) {
+#ifdef __linux__
+    const uintptr_t HUGE_PAGE = uintptr_t(1) << 21;
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(array) + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(array + count) & ~(HUGE_PAGE - 1);
+    if (begin < end) {
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+// LazySegmentTree class: range queries over any monoid and range updates by any lazy tag,
+// iterative and bottom-up over one contiguous array of 2 * capacity nodes (capacity is the
+// next power of two; leaves at [capacity, 2 * capacity), node i has children 2i and 2i + 1).
+// Before touching a range, the tags on the paths down to its two boundary leaves are pushed
+// to the children, so every node in between is exact. Positions are 0-based and ranges
+// half-open [l, r).
+template <typename Monoid, typename Tag = NoTag>
+class LazySegmentTree {
+    typedef typename Monoid::Value Value;
+    typedef typename Tag::Update Update;
+    static const bool LAZY = !is_same<Tag, NoTag>::value;
+    static const int PREFETCH_LEVELS = 3;   // Bottom levels of a query path prefetched up front
+
+    SegmentNode<Value, Update>* nodes;  // Nodes of the tree
+    int size;                           // Number of elements
+    int capacity;                       // Number of leaves (a power of two)
+    int levels;                         // log2(capacity)
+
+    // Function to recompute node i from its children
+    void pull(int i) {
+        nodes[i].value = Monoid::combine(nodes[2 * i].value, nodes[2 * i + 1].value);
+    }
+
+    // Function to apply an update to the whole subtree of node i
+    void applyAt(int i, const Update& f) {
+        nodes[i].value = Tag::apply(f, nodes[i].value);
+        if constexpr (LAZY) {
+            if (i < capacity) {
+                nodes[i].lazy = Tag::compose(f, nodes[i].lazy);
+            }
+        }
+    }
+
+    // Function to hand the tag of node i down to its children
+    void push(int i) {
+        if constexpr (LAZY) {
+            applyAt(2 * i, nodes[i].lazy);
+            applyAt(2 * i + 1, nodes[i].lazy);
+            nodes[i].lazy = Tag::identity();
+        }
+    }
+
+    // Function to push every tag on the path from the root to leaf i
+    void pushPath(int leaf) {
+        if constexpr (LAZY) {
+            for (int level = levels; level >= 1; level--) {
+                push(leaf >> level);
+            }
+        }
+    }
+
+    // Function to push the tags above the boundaries of [l, r) (leaf indices)
+    void pushBoundaries(int l, int r) {
+        if constexpr (LAZY) {
+            for (int level = levels; level >= 1; level--) {
+                if (((l >> level) << level) != l) {
+                    push(l >> level);
+                }
+                if (((r >> level) << level) != r) {
+                    push((r - 1) >> level);
+                }
+            }
+        }
+    }
+
+    // Function to check a position
+    void check(int p) {
+        if (p < 0 || p >= size) {
+            throw out_of_range("Position out of range");
+        }
+    }
+
+    // Function to check a range
+    void check(int l, int r) {
+        if (l < 0 || r > size || l > r) {
+            throw out_of_range("Range out of range");
+        }
+    }
+
+public:
+    // Constructor for n identity elements
+    LazySegmentTree(int n) {
+        size = max(0, n);
+        levels = 0;
+        while ((1 << levels) < size) {
+            levels++;
+        }
+        capacity = 1 << levels;
+        nodes = new SegmentNode<Value, Update>[2 * capacity];
+        adviseHugePages(nodes, 2 * size_t(capacity));
+
+        for (int i = 0; i < 2 * capacity; i++) {
+            nodes[i].value = Monoid::identity();
+            if constexpr (LAZY) {
+                nodes[i].lazy = Tag::identity();
+            }
+        }
+    }
+
+    // Constructor to build the tree from an array in O(n)
+    LazySegmentTree(const Value other[], int n) : LazySegmentTree(n) {
+        for (int p = 0; p < size; p++) {
+            nodes[capacity + p].value = other[p];
+        }
+        for (int i = capacity - 1; i >= 1; i--) {
+            pull(i);
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~LazySegmentTree() {
+        delete[] nodes;
+    }
+
+    LazySegmentTree(const LazySegmentTree&) = delete;
+    LazySegmentTree& operator=(const LazySegmentTree&) = delete;
+
+    // Function to get the number of elements
+    int length() {
+        return size;
+    }
+
+    // Function to set the element at position p
+    void set(int p, const Value& x) {
+        check(p);
+        int leaf = p + capacity;
+        pushPath(leaf);
+        nodes[leaf].value = x;
+        for (int level = 1; level <= levels; level++) {
+            pull(leaf >> level);
+        }
+    }
+
+    // Function to combine x into the element at position p (a point add for sums). With a
+    // commutative monoid, combining x into each ancestor gives the same value as recomputing
+    // it, and skips reading the sibling at every level.
+    void add(int p, const Value& x) {
+        check(p);
+        int leaf = p + capacity;
+        pushPath(leaf);
+        if constexpr (isCommutative<Monoid>::value) {
+            for (int i = leaf; i >= 1; i >>= 1) {
+                nodes[i].value = Monoid::combine(nodes[i].value, x);
+            }
+        } else {
+            nodes[leaf].value = Monoid::combine(nodes[leaf].value, x);
+            for (int level = 1; level <= levels; level++) {
+                pull(leaf >> level);
+            }
+        }
+    }
+
+    /**
+     * Sets many elements at once. The positions are sorted so that the ancestors shared by
+     * nearby updates are recomputed once per level instead of once per update.
+     *
+     * @param updates (position, value) pairs; for a repeated position the last one wins.
+     */
+    void setBatch(vector<pair<int, Value>> updates) {
+        for (auto& update : updates) {
+            check(update.first);
+        }
+        stable_sort(updates.begin(), updates.end(), [](const pair<int, Value>& a, const pair<int, Value>& b) {
+            return a.first < b.first;
+        });
+
+        for (auto& update : updates) {
+            int leaf = update.first + capacity;
+            pushPath(leaf);
+            nodes[leaf].value = update.second;
+        }
+        for (int level = 1; level <= levels; level++) {
+            int previous = 0;
+            for (auto& update : updates) {
+                int i = (update.first + capacity) >> level;
+                if (i != previous) {
+                    pull(i);
+                    previous = i;
+                }
+            }
+        }
+    }
+
+    // Function to get the element at position p
+    Value get(int p) {
+        check(p);
+        int leaf = p + capacity;
+        pushPath(leaf);
+        return nodes[leaf].value;
+    }
+
+    // Function to combine the elements in [l, r)
+    Value query(int l, int r) {
+        check(l, r);
+        if (l == r) {
+            return Monoid::identity();
+        }
+
+        l += capacity;
+        r += capacity;
+        pushBoundaries(l, r);
+
+        // The lowest levels of the two boundary paths are the nodes least likely to be cached;
+        // requesting them up front overlaps their misses instead of taking them one per level
+        for (int level = 0; level < PREFETCH_LEVELS && level <= levels; level++) {
+            __builtin_prefetch(&nodes[l >> level]);
+            __builtin_prefetch(&nodes[(r - 1) >> level]);
+        }
+
+        // Walk both boundaries up, keeping the left and right parts apart (combine need not
+        // commute). A boundary node outside the range is not skipped but swapped for node 0,
+        // which the tree never uses and which always holds the identity: the index is picked
+        // arithmetically, so the loop has no branches to mispredict and never loads the
+        // skipped node.
+        Value left = Monoid::identity(), right = Monoid::identity();
+        while (l < r) {
+            left = Monoid::combine(left, nodes[l & -(l & 1)].value);
+            right = Monoid::combine(nodes[(r - 1) & -(r & 1)].value, right);
+            l = (l + 1) >> 1;
+            r >>= 1;
+        }
+
+        return Monoid::combine(left, right);
+    }
+
+    // Function to combine all the elements
+    Value all() {
+        return nodes[1].value;
+    }
+
+    // Function to apply an update to the element at position p
+    void apply(int p, const Update& f) {
+        check(p);
+        int leaf = p + capacity;
+        pushPath(leaf);
+        nodes[leaf].value = Tag::apply(f, nodes[leaf].value);
+        for (int level = 1; level <= levels; level++) {
+            pull(leaf >> level);
+        }
+    }
+
+    // Function to apply an update to every element in [l, r)
+    void apply(int l, int r, const Update& f) {
+        check(l, r);
+        if (l == r) {
+            return;
+        }
+
+        l += capacity;
+        r += capacity;
+        pushBoundaries(l, r);
+
+        // Tag the O(log n) nodes covering the range, then recompute the boundary paths
+        for (int a = l, b = r; a < b; a >>= 1, b >>= 1) {
+            if (a & 1) {
+                applyAt(a++, f);
+            }
+            if (b & 1) {
+                applyAt(--b, f);
+            }
+        }
+        for (int level = 1; level <= levels; level++) {
+            if (((l >> level) << level) != l) {
+                pull(l >> level);
+            }
+            if (((r >> level) << level) != r) {
+                pull((r - 1) >> level);
+            }
+        }
+    }
+
+    /**
+     * Binary search to the right: the largest r such that pred(query(l, r)) is true.
+     * pred must be true for the identity and stay false once it turns false as r grows.
+     *
+     * @param l The left end of the ranges.
+     * @param pred The predicate on combined values.
+     * @return The largest such r (size if pred holds for all of [l, size)).
+     */
+    template <typename Pred>
+    int maxRight(int l, Pred pred) {
+        check(l, l);
+        if (l == size) {
+            return size;
+        }
+
+        l += capacity;
+        pushPath(l);
+        Value sum = Monoid::identity();
+        do {
+            // Climb while l is a right child, then try to take the whole node l
+            while (l % 2 == 0) {
+                l >>= 1;
+            }
+            if (!pred(Monoid::combine(sum, nodes[l].value))) {
+                // The answer is inside node l: descend, taking left children while they fit
+                while (l < capacity) {
+                    push(l);
+                    l = 2 * l;
+                    if (pred(Monoid::combine(sum, nodes[l].value))) {
+                        sum = Monoid::combine(sum, nodes[l].value);
+                        l++;
+                    }
+                }
+                return min(l - capacity, size);
+            }
+            sum = Monoid::combine(sum, nodes[l].value);
+            l++;
+        } while ((l & -l) != l);
+
+        return size;
+    }
+
+    /**
+     * Binary search to the left: the smallest l such that pred(query(l, r)) is true.
+     * pred must be true for the identity and stay false once it turns false as l shrinks.
+     *
+     * @param r The right end of the ranges.
+     * @param pred The predicate on combined values.
+     * @return The smallest such l (0 if pred holds for all of [0, r)).
+     */
+    template <typename Pred>
+    int minLeft(int r, Pred pred) {
+        check(r, r);
+        if (r == 0) {
+            return 0;
+        }
+
+        r += capacity;
+        pushPath(r - 1);
+        Value sum = Monoid::identity();
+        do {
+            // Climb while r - 1 is a left child, then try to take the whole node r - 1
+            r--;
+            while (r > 1 && (r % 2)) {
+                r >>= 1;
+            }
+            if (!pred(Monoid::combine(nodes[r].value, sum))) {
+                // The answer is inside node r: descend, taking right children while they fit
+                while (r < capacity) {
+                    push(r);
+                    r = 2 * r + 1;
+                    if (pred(Monoid::combine(nodes[r].value, sum))) {
+                        sum = Monoid::combine(nodes[r].value, sum);
+                        r--;
+                    }
+                }
+                return r + 1 - capacity;
+            }
+            sum = Monoid::combine(nodes[r].value, sum);
+        } while ((r & -r) != r);
+
+        return 0;
     }
 };
 
+// Integer modulo a prime, as an example of a non-builtin value type
+struct ModInt {
+    static const long long MOD = 1000000007LL;
+    long long value;
+
+    ModInt(long long v = 0) {
+        value = ((v % MOD) + MOD) % MOD;
+    }
+
+    ModInt operator+(const ModInt& other) const {
+        return ModInt(value + other.value);
+    }
+
+    ModInt operator-(const ModInt& other) const {
+        return ModInt(value - other.value);
+    }
 
-int main() {
+    ModInt operator*(const ModInt& other) const {
+        return ModInt(value * other.value);
+    }
+
+    bool operator==(const ModInt& other) const {
+        return value == other.value;
+    }
+};
+
+/**
+ * Mixed read / write throughput on a shared histogram: every thread performs ops operations,
+ * a writeShare fraction of them adds and the rest prefix queries, on a FenwickTree behind a
+ * mutex, a ConcurrentFenwickTree and a ConcurrentFenwickTree with one shard per thread.
+ */
+void concurrentFenwickBenchmark(int n, int threads, int ops) {
+    for (int writePercent = 90; writePercent >= 10; writePercent -= 40) {
+        FenwickTree<long> locked(n);
+        mutex lock;
+        ConcurrentFenwickTree<long> shared(n), sharded(n, threads);
+        double seconds[3];
+
+        for (int variant = 0; variant < 3; variant++) {
+            auto start = chrono::steady_clock::now();
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    unsigned int seed = 1 + t;
+                    long checksum = 0;
+                    for (int op = 0; op < ops; op++) {
+                        seed = seed * 1103515245u + 12345u;
+                        int i = 1 + (seed >> 4) % n;
+                        bool write = (int) ((seed >> 24) % 100) < writePercent;
+                        if (variant == 0) {
+                            lock_guard<mutex> guard(lock);
+                            if (write) {
+                                locked.add(i, 1);
+                            } else {
+                                checksum += locked.prefixSum(i);
+                            }
+                        } else {
+                            ConcurrentFenwickTree<long>& tree = (variant == 1) ? shared : sharded;
+                            if (write) {
+                                tree.add(i, 1);
+                            } else {
+                                checksum += tree.prefixSum(i);
+                            }
+                        }
+                    }
+                    assert(checksum >= 0);
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            seconds[variant] = elapsed.count();
+        }
+
+        assert(locked.prefixSum(n) == shared.prefixSum(n) && shared.prefixSum(n) == sharded.prefixSum(n));
+        cout << writePercent << "% writes, " << threads << " threads: mutex " << seconds[0]
+             << "s, atomic " << seconds[1] << "s, sharded " << seconds[2] << "s" << endl;
+    }
+}
+
+// Time random adds, then random prefix queries, on one tree; returns the checksum of the queries
+template <typename Tree>
+long timeLayout(Tree& tree, const vector<int>& indices, double& addSeconds, double& querySeconds) {
+    auto start = chrono::steady_clock::now();
+    for (int index : indices) {
+        tree.add(index, 1);
+    }
+    chrono::duration<double> addTime = chrono::steady_clock::now() - start;
+
+    long checksum = 0;
+    start = chrono::steady_clock::now();
+    for (int index : indices) {
+        checksum += tree.prefixSum(index);
+    }
+    chrono::duration<double> queryTime = chrono::steady_clock::now() - start;
+    addSeconds = addTime.count();
+    querySeconds = queryTime.count();
+    return checksum;
+}
+
+/**
+ * Layout benchmark at a given size: random adds and prefix queries on the flat FenwickTree
+ * and on BlockedFenwickTree, each tree allocated on its own. BlockedFenwickTree is meant to win
+ * only once the array outgrows the last-level cache, so pass a larger n on the command line to
+ * see it. Memory: the flat tree takes 8n bytes and the blocked one about 9n (blocks plus the top
+ * tree), one at a time, so n = 1e9 needs about 9GB free.
+ */
+void blockedFenwickBenchmark(int n, int ops) {
+    vector<int> indices(ops);
+    unsigned int seed = 31;
+    for (int& index : indices) {
+        seed = seed * 1103515245u + 12345u;
+        index = 1 + (int) (((unsigned long long) seed * 2654435761u) % n);
+    }
+
+    double flatAdd, flatQuery, blockedAdd, blockedQuery;
+    long flatChecksum, blockedChecksum;
+    {
+        FenwickTree<long> flat(n);
+        flatChecksum = timeLayout(flat, indices, flatAdd, flatQuery);
+    }
+    {
+        BlockedFenwickTree<long> blocked(n);
+        blockedChecksum = timeLayout(blocked, indices, blockedAdd, blockedQuery);
+    }
+
+    assert(flatChecksum == blockedChecksum);
+    cout << "n = " << n << ": add flat " << flatAdd << "s, blocked " << blockedAdd
+         << "s; prefixSum flat " << flatQuery << "s, blocked " << blockedQuery << "s" << endl;
+}
+
+/**
+ * Plain sums: random point adds and range sums on FenwickTree and on a LazySegmentTree
+ * over the sum monoid without tags.
+ */
+void segmentTreeBenchmark(int n, int ops) {
+    vector<pair<int, int>> ranges(ops);
+    unsigned int seed = 57;
+    for (auto& range : ranges) {
+        seed = seed * 1103515245u + 12345u;
+        range.first = (seed >> 4) % n;
+        seed = seed * 1103515245u + 12345u;
+        range.second = (seed >> 4) % n;
+        if (range.first > range.second) {
+            swap(range.first, range.second);
+        }
+    }
+
+    // Each structure gets the best of three fresh runs, so one noisy run does not decide the ratio
+    double fenwickTime = numeric_limits<double>::max(), segmentTime = numeric_limits<double>::max();
+    long fenwickChecksum = 0, segmentChecksum = 0;
+    for (int run = 0; run < 3; run++) {
+        FenwickTree<long> fenwick(n);
+        fenwickChecksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (auto& range : ranges) {
+            fenwick.add(range.first + 1, 1);
+            fenwickChecksum += fenwick.sum(range.first + 1, range.second + 1);
+        }
+        fenwickTime = min(fenwickTime, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+        LazySegmentTree<SumMonoid<long>> segment(n);
+        segmentChecksum = 0;
+        start = chrono::steady_clock::now();
+        for (auto& range : ranges) {
+            segment.add(range.first, 1);
+            segmentChecksum += segment.query(range.first, range.second + 1);
+        }
+        segmentTime = min(segmentTime, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+
+    assert(fenwickChecksum == segmentChecksum);
+    cout << "n = " << n << ": FenwickTree " << fenwickTime << "s, LazySegmentTree "
+         << segmentTime << "s" << endl;
+}
+
+int main(int argc, char* argv[]) {
     // Test case 1: Creating a FenwickTree object and testing prefixSum() and add() methods
     cout << "Test Case 1:" << endl;
     FenwickTree tree(10); // Create a FenwickTree object of size 10
@@ -128,7 +1351,404 @@ int main() {
     assert(tree2.sum(2, 7) == 42);
     assert(tree2.sum(4, 9) == 54);
 
-    cout << "All sums are correct." << endl;
+    // The last element of an array-built tree can be updated too
+    tree2.add(10, 1);
+    assert(tree2.get(10) == 11 && tree2.sum(10, 10) == 11);
+
+    cout << "All sums are correct." << endl << endl;
+
+    // Test case 3: get() and lowerBound() as rank / select over counts
+    cout << "Test Case 3:" << endl;
+    for (int i = 1; i <= 10; i++) {
+        assert(tree2.get(i) == (i == 5 ? 20 : i == 10 ? 11 : i));
+    }
+    FenwickTree<int> counts(13);
+    int values[] = { 0, 2, 0, 1, 3, 0, 0, 1, 0, 0, 0, 0, 4 };
+    for (int i = 1; i <= 13; i++) {
+        counts.add(i, values[i - 1]);
+    }
+    assert(counts.lowerBound(0) == 1);
+    assert(counts.lowerBound(1) == 2 && counts.lowerBound(2) == 2);
+    assert(counts.lowerBound(3) == 4);
+    assert(counts.lowerBound(4) == 5 && counts.lowerBound(6) == 5);
+    assert(counts.lowerBound(7) == 8);
+    assert(counts.lowerBound(8) == 13 && counts.lowerBound(11) == 13);
+    assert(counts.lowerBound(12) == 14);
+
+    // Weighted sampling over doubles
+    FenwickTree<double> weights(4);
+    double w[] = { 0.5, 0.25, 0.0, 0.25 };
+    for (int i = 1; i <= 4; i++) {
+        weights.add(i, w[i - 1]);
+    }
+    assert(weights.lowerBound(0.3) == 1);
+    assert(weights.lowerBound(0.6) == 2);
+    assert(weights.lowerBound(0.8) == 4);
+    assert(fabs(weights.sum(2, 4) - 0.5) < 1e-12);
+
+    cout << "Rank and select are correct." << endl << endl;
+
+    // Test case 4: Range add and range sum against a plain array, with long and modular values
+    cout << "Test Case 4:" << endl;
+    const int n = 300;
+    RangeFenwickTree<long long> ranges(n);
+    RangeFenwickTree<ModInt> modRanges(n);
+    long long plain[n + 1] = { 0 };
+    unsigned int seed = 17;
+    for (int step = 0; step < 2000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int l = 1 + (seed >> 8) % n;
+        seed = seed * 1103515245u + 12345u;
+        int r = 1 + (seed >> 8) % n;
+        if (l > r) {
+            swap(l, r);
+        }
+        seed = seed * 1103515245u + 12345u;
+        long long k = (long long) ((seed >> 8) % 2001) - 1000;
+
+        if (step % 2 == 0) {
+            ranges.rangeAdd(l, r, k);
+            modRanges.rangeAdd(l, r, ModInt(k));
+            for (int i = l; i <= r; i++) {
+                plain[i] += k;
+            }
+        } else {
+            long long expected = 0;
+            for (int i = l; i <= r; i++) {
+                expected += plain[i];
+            }
+            assert(ranges.sum(l, r) == expected);
+            assert(modRanges.sum(l, r) == ModInt(expected));
+            assert(ranges.get(l) == plain[l]);
+        }
+    }
+
+    cout << "All range sums are correct." << endl << endl;
+
+    // Test case 5: Concurrent adds from many threads, single and sharded, with readers running
+    cout << "Test Case 5:" << endl;
+    for (int shardCount = 1; shardCount <= 4; shardCount += 3) {
+        ConcurrentFenwickTree<long long> histogram(1000, shardCount);
+        atomic<bool> writing(true);
+        thread reader([&histogram, &writing]() {
+            long long previous = 0;
+            while (writing.load()) {
+                // Only adds of positive values, so the total never goes down
+                long long total = histogram.prefixSum(1000);
+                assert(total >= previous);
+                previous = total;
+            }
+        });
+        vector<thread> writers;
+        for (int t = 0; t < 4; t++) {
+            writers.emplace_back([&histogram, t]() {
+                for (int i = 1; i <= 1000; i++) {
+                    histogram.add(i, i + t);
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        writing.store(false);
+        reader.join();
+        for (int i = 1; i <= 1000; i += 37) {
+            assert(histogram.sum(i, i) == 4LL * i + 6);
+        }
+        assert(histogram.prefixSum(1000) == 4LL * 500500 + 6000);
+    }
+
+    cout << "All concurrent sums are correct." << endl << endl;
+
+    // Test case 6: 2D tree, built by adds and in bulk, against a plain grid
+    cout << "Test Case 6:" << endl;
+    const int gridRows = 37, gridCols = 53;
+    vector<long long> grid(gridRows * gridCols);
+    for (auto& cell : grid) {
+        seed = seed * 1103515245u + 12345u;
+        cell = (long long) ((seed >> 8) % 100) - 50;
+    }
+    FenwickTree2D<long long> byAdds(gridRows, gridCols);
+    for (int r = 1; r <= gridRows; r++) {
+        for (int c = 1; c <= gridCols; c++) {
+            byAdds.add(r, c, grid[(r - 1) * gridCols + (c - 1)]);
+        }
+    }
+    FenwickTree2D<long long> bulk(grid.data(), gridRows, gridCols);
+    for (int step = 0; step < 500; step++) {
+        int corners[4];
+        for (int& corner : corners) {
+            seed = seed * 1103515245u + 12345u;
+            corner = (seed >> 8);
+        }
+        int r1 = 1 + corners[0] % gridRows, r2 = 1 + corners[1] % gridRows;
+        int c1 = 1 + corners[2] % gridCols, c2 = 1 + corners[3] % gridCols;
+        if (r1 > r2) {
+            swap(r1, r2);
+        }
+        if (c1 > c2) {
+            swap(c1, c2);
+        }
+        long long expected = 0;
+        for (int r = r1; r <= r2; r++) {
+            for (int c = c1; c <= c2; c++) {
+                expected += grid[(r - 1) * gridCols + (c - 1)];
+            }
+        }
+        assert(byAdds.sum(r1, c1, r2, c2) == expected);
+        assert(bulk.sum(r1, c1, r2, c2) == expected);
+
+        // Point update between queries
+        bulk.add(r2, c1, 3);
+        byAdds.add(r2, c1, 3);
+        grid[(r2 - 1) * gridCols + (c1 - 1)] += 3;
+    }
+
+    cout << "All rectangle sums are correct." << endl << endl;
+
+    // Test case 7: Sparse 2D tree over a 10^6 x 10^6 domain
+    cout << "Test Case 7:" << endl;
+    vector<pair<int, int>> points;
+    vector<long long> pointWeights;
+    for (int p = 0; p < 3000; p++) {
+        seed = seed * 1103515245u + 12345u;
+        int x = (seed >> 4) % 1000000;
+        seed = seed * 1103515245u + 12345u;
+        int y = (seed >> 4) % 1000000;
+        points.push_back(make_pair(x % 7 == 0 ? 424242 : x, y));
+        pointWeights.push_back(1 + p % 5);
+    }
+    points.push_back(points[5]);    // A duplicate point
+    pointWeights.push_back(100);
+
+    SparseFenwickTree2D<long long> sparse(points);
+    for (size_t p = 0; p < points.size(); p++) {
+        sparse.add(points[p].first, points[p].second, pointWeights[p]);
+    }
+    SparseFenwickTree2D<long long> sparseBulk(points, pointWeights);
+    for (int step = 0; step < 300; step++) {
+        int box[4];
+        for (int& side : box) {
+            seed = seed * 1103515245u + 12345u;
+            side = (seed >> 4) % 1000000;
+        }
+        int x1 = min(box[0], box[1]), x2 = max(box[0], box[1]);
+        int y1 = min(box[2], box[3]), y2 = max(box[2], box[3]);
+        long long expected = 0;
+        for (size_t p = 0; p < points.size(); p++) {
+            if (points[p].first >= x1 && points[p].first <= x2 && points[p].second >= y1 && points[p].second <= y2) {
+                expected += pointWeights[p];
+            }
+        }
+        assert(sparse.sum(x1, y1, x2, y2) == expected);
+        assert(sparseBulk.sum(x1, y1, x2, y2) == expected);
+    }
+    assert(sparse.sum(0, 0, 999999, 999999) == sparseBulk.prefixSum(1000000, 1000000));
+    bool thrown = false;
+    try {
+        sparse.add(points[0].first, points[0].second + 1, 1);
+    } catch (invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    cout << "All sparse rectangle sums are correct." << endl << endl;
+
+    // Test case 8: Blocked layout agrees with the flat tree, across block boundaries
+    cout << "Test Case 8:" << endl;
+    const int blockedSize = 5000;
+    vector<long> initial(blockedSize);
+    for (auto& value : initial) {
+        seed = seed * 1103515245u + 12345u;
+        value = (long) ((seed >> 8) % 1000) - 500;
+    }
+    FenwickTree<long> flat(initial.data(), blockedSize);
+    BlockedFenwickTree<long> blocked(initial.data(), blockedSize);
+    BlockedFenwickTree<long, 3> oddBlocks(blockedSize);
+    for (int i = 1; i <= blockedSize; i++) {
+        oddBlocks.add(i, initial[i - 1]);
+    }
+    for (int step = 0; step < 3000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int i = 1 + (seed >> 8) % blockedSize;
+        seed = seed * 1103515245u + 12345u;
+        int j = 1 + (seed >> 8) % blockedSize;
+        if (i > j) {
+            swap(i, j);
+        }
+        assert(blocked.sum(i, j) == flat.sum(i, j));
+        assert(oddBlocks.sum(i, j) == flat.sum(i, j));
+        assert(blocked.get(j) == flat.get(j));
+        if (step % 3 == 0) {
+            blocked.set(i, step);
+            oddBlocks.set(i, step);
+            flat.set(i, step);
+        } else {
+            blocked.add(j, -step);
+            oddBlocks.add(j, -step);
+            flat.add(j, -step);
+        }
+    }
+    assert(blocked.prefixSum(blockedSize) == flat.prefixSum(blockedSize));
+    assert(blocked.length() == blockedSize);
+    BlockedFenwickTree<int, 4> blockedCounts(values, 13);
+    for (int target = 0; target <= 12; target++) {
+        assert(blockedCounts.lowerBound(target) == counts.lowerBound(target));
+    }
+
+    cout << "All blocked sums are correct." << endl << endl;
+
+    // Test case 9: Segment tree on sums: point updates, batches and binary searches
+    cout << "Test Case 9:" << endl;
+    const int segmentSize = 777;
+    vector<long> plainValues(segmentSize);
+    for (auto& value : plainValues) {
+        seed = seed * 1103515245u + 12345u;
+        value = (seed >> 8) % 100;
+    }
+    LazySegmentTree<SumMonoid<long>> sums(plainValues.data(), segmentSize);
+    for (int step = 0; step < 2000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int l = (seed >> 8) % (segmentSize + 1);
+        seed = seed * 1103515245u + 12345u;
+        int r = (seed >> 8) % (segmentSize + 1);
+        if (l > r) {
+            swap(l, r);
+        }
+        long expected = 0;
+        for (int p = l; p < r; p++) {
+            expected += plainValues[p];
+        }
+        assert(sums.query(l, r) == expected);
+
+        // Largest r' with sum [l, r') <= limit, against a linear scan
+        long limit = (long) ((seed >> 4) % 3000);
+        int right = l;
+        long running = 0;
+        while (right < segmentSize && running + plainValues[right] <= limit) {
+            running += plainValues[right++];
+        }
+        assert(sums.maxRight(l, [limit](long s) { return s <= limit; }) == right);
+        int left = r;
+        running = 0;
+        while (left > 0 && running + plainValues[left - 1] <= limit) {
+            running += plainValues[--left];
+        }
+        assert(sums.minLeft(r, [limit](long s) { return s <= limit; }) == left);
+
+        if (step % 3 == 0) {
+            sums.set(l % segmentSize, step % 50);
+            plainValues[l % segmentSize] = step % 50;
+        } else if (step % 3 == 1) {
+            sums.add(r % segmentSize, 7);
+            plainValues[r % segmentSize] += 7;
+        } else {
+            vector<pair<int, long>> batch;
+            for (int k = 0; k < 20; k++) {
+                seed = seed * 1103515245u + 12345u;
+                batch.push_back(make_pair((int) ((seed >> 8) % segmentSize), (long) k));
+            }
+            sums.setBatch(batch);
+            for (auto& update : batch) {
+                plainValues[update.first] = update.second;
+            }
+        }
+    }
+    assert(sums.all() == sums.query(0, segmentSize));
+
+    // Range add with range min, range assign with range max, against plain arrays
+    LazySegmentTree<MinMonoid<int>, AddTag<int>> mins(segmentSize);
+    LazySegmentTree<MaxMonoid<int>, AssignTag<int>> maxes(segmentSize);
+    vector<int> minValues(segmentSize, numeric_limits<int>::max());
+    vector<int> maxValues(segmentSize, numeric_limits<int>::lowest());
+    for (int p = 0; p < segmentSize; p++) {
+        mins.set(p, p % 13);
+        minValues[p] = p % 13;
+    }
+    for (int step = 0; step < 2000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int l = (seed >> 8) % segmentSize;
+        seed = seed * 1103515245u + 12345u;
+        int r = 1 + (seed >> 8) % segmentSize;
+        if (l >= r) {
+            swap(l, r);
+            r++;
+        }
+        int k = (int) ((seed >> 4) % 21) - 10;
+        if (step % 2 == 0) {
+            mins.apply(l, r, k);
+            maxes.apply(l, r, AssignTag<int>::Update{ true, k });
+            for (int p = l; p < r; p++) {
+                minValues[p] += k;
+                maxValues[p] = k;
+            }
+        } else {
+            int expectedMin = numeric_limits<int>::max(), expectedMax = numeric_limits<int>::lowest();
+            for (int p = l; p < r; p++) {
+                expectedMin = min(expectedMin, minValues[p]);
+                expectedMax = max(expectedMax, maxValues[p]);
+            }
+            assert(mins.query(l, r) == expectedMin);
+            assert(maxes.query(l, r) == expectedMax);
+            assert(mins.get(l) == minValues[l]);
+
+            // First position from l whose value drops below k
+            int below = l;
+            while (below < segmentSize && minValues[below] >= k) {
+                below++;
+            }
+            assert(mins.maxRight(l, [k](int m) { return m >= k; }) == below);
+        }
+    }
+
+    // Range affine updates on modular sums
+    vector<SumLength<ModInt>> unit(segmentSize, SumLength<ModInt>{ ModInt(1), 1 });
+    LazySegmentTree<SumLengthMonoid<ModInt>, AffineTag<ModInt>> affine(unit.data(), segmentSize);
+    vector<ModInt> affineValues(segmentSize, ModInt(1));
+    for (int step = 0; step < 1000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int l = (seed >> 8) % segmentSize;
+        seed = seed * 1103515245u + 12345u;
+        int r = l + 1 + (seed >> 8) % (segmentSize - l);
+        if (step % 2 == 0) {
+            ModInt mul((seed >> 4) % 1000), shift((seed >> 12) % 1000);
+            affine.apply(l, r, AffineTag<ModInt>::Update{ mul, shift });
+            for (int p = l; p < r; p++) {
+                affineValues[p] = mul * affineValues[p] + shift;
+            }
+        } else {
+            ModInt expected;
+            for (int p = l; p < r; p++) {
+                expected = expected + affineValues[p];
+            }
+            SumLength<ModInt> result = affine.query(l, r);
+            assert(result.sum == expected && result.length == r - l);
+        }
+    }
+    bool rangeThrown = false;
+    try {
+        affine.query(3, segmentSize + 1);
+    } catch (out_of_range&) {
+        rangeThrown = true;
+    }
+    assert(rangeThrown);
+
+    cout << "All segment tree queries are correct." << endl << endl;
+
+    concurrentFenwickBenchmark(1 << 16, 4, 500000);
+    blockedFenwickBenchmark(1000000, 4000000);
+    blockedFenwickBenchmark(10000000, 4000000);
+    // Opt-in larger size for the layout benchmark, up to 1e9 (see blockedFenwickBenchmark for memory)
+    if (argc > 1) {
+        long long n = atoll(argv[1]);
+        if (n < 1 || n > 1000000000) {
+            cerr << "Benchmark size must be between 1 and 1e9" << endl;
+            return 1;
+        }
+        blockedFenwickBenchmark((int) n, 4000000);
+    }
+    segmentTreeBenchmark(100000, 4000000);
+    segmentTreeBenchmark(1000000, 4000000);
 
     return 0;
 }
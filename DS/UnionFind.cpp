@@ -9,18 +9,107 @@
 */
 
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <map>
+#include <set>
+#include <mutex>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
 #include <cassert>
+#include "denseKeyMap.h"
 
 using namespace std;
 
+// Split [0, n) into one contiguous range per thread and run body(begin, end, thread) on each
+template <typename F>
+void parallelFor(int threads, int n, F body) {
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++) {
+        int begin = (int) ((long long) n * t / threads);
+        int end = (int) ((long long) n * (t + 1) / threads);
+        workers.emplace_back(body, begin, end, t);
+    }
+    for(auto& worker : workers) {
+        worker.join();
+    }
+}
+
 // UnionFind class for implementing the union-find data structure
 class UnionFind {
     private:
     int* sizes;                 // Array to store the size of each component
     int* ids;                   // Array to store the parent id of each element
+    int* nexts = nullptr;       // Circular list of the members of each component, built on the first member query
     int componentsCount = 0;    // Count of total components
     int count = 0;              // Count of total elements
 
+    static const int PREFETCH_DISTANCE = 16;    // Number of finds a batch prefetches ahead
+
+    // Merge the smaller of two different roots into the larger one
+    void link(int root1, int root2) {
+        // Merge the smaller component into the larger component
+        if(sizes[root1] < sizes[root2]) {
+            sizes[root2] += sizes[root1];
+            ids[root1] = root2;
+        } else {
+            sizes[root1] += sizes[root2];
+            ids[root2] = root1;
+        }
+
+        // Splice the two member lists into one cycle
+        if(nexts != nullptr) {
+            swap(nexts[root1], nexts[root2]);
+        }
+
+        // Decrease the component count
+        componentsCount--;
+    }
+
+    // Build the member lists of every component: each root starts a cycle of its own and every
+    // other element is spliced in after its root. Deferred to the first member query, so users
+    // that never ask for members do not pay for the extra array
+    void buildMemberLists() {
+        nexts = new int[count];
+        for(int i = 0; i < count; i++) {
+            nexts[i] = i;
+        }
+        for(int i = 0; i < count; i++) {
+            int root = find(i);
+            if(root != i) {
+                nexts[i] = nexts[root];
+                nexts[root] = i;
+            }
+        }
+    }
+
+    // Batched finds prefetch the first two hops of later finds in two stages: an element's
+    // slot is requested 2 * PREFETCH_DISTANCE finds ahead, and its parent's slot
+    // PREFETCH_DISTANCE finds ahead, by which time the element's own slot has arrived
+    void prefetchSlot(int x) {
+        __builtin_prefetch(&ids[x]);
+    }
+
+    void prefetchParent(int x) {
+        __builtin_prefetch(&ids[ids[x]]);
+    }
+
     public:
     // Constructor to initialize the UnionFind object
     UnionFind(int _count) {
@@ -35,6 +124,16 @@ class UnionFind {
         }
     }
 
+    // Destructor to deallocate memory
+    ~UnionFind() {
+        delete[] sizes;
+        delete[] ids;
+        delete[] nexts;
+    }
+
+    UnionFind(const UnionFind&) = delete;
+    UnionFind& operator=(const UnionFind&) = delete;
+
     // Find the root of the given element
     int find(int index) {
         int root = index;
@@ -54,6 +153,15 @@ class UnionFind {
         return root;
     }
 
+    // Find the root of the given element without compressing the path; it only reads,
+    // so many threads may call it at once as long as no unions run meanwhile
+    int root(int index) const {
+        while(index != ids[index]) {
+            index = ids[index];
+        }
+        return index;
+    }
+
     // Check if two elements are connected
     bool connected(int x, int y) {
         return (find(x) == find(y));
@@ -84,20 +192,1506 @@ class UnionFind {
             return;
         }
 
+        link(root1, root2);
+    }
+
+    // Call visit(member) for every member of the component containing x, in O(size)
+    // (the first call of this or members() also builds the member lists, in O(n))
+    template <typename F>
+    void forEachMember(int x, F visit) {
+        if(nexts == nullptr) {
+            buildMemberLists();
+        }
+        int member = x;
+        do {
+            visit(member);
+            member = nexts[member];
+        } while(member != x);
+    }
+
+    // Get the members of the component containing the given element, starting with it
+    vector<int> members(int x) {
+        vector<int> result;
+        result.reserve(sizes[find(x)]);
+        forEachMember(x, [&result](int member) {
+            result.push_back(member);
+        });
+        return result;
+    }
+
+    /**
+     * Labels every element with the root of its component and flattens the forest, so later
+     * finds take one hop. The roots are looked up in parallel without modifying anything,
+     * then every element is pointed straight at its root.
+     *
+     * @param out Receives the label (root) of every element.
+     * @param threads Number of worker threads.
+     */
+    void labels(vector<int>& out, int threads = 1) {
+        out.resize(count);
+        int* result = out.data();
+        threads = max(1, threads);
+        parallelFor(threads, count, [this, result](int begin, int end, int) {
+            for(int v = begin; v < end; v++) {
+                result[v] = root(v);
+            }
+        });
+        parallelFor(threads, count, [this, result](int begin, int end, int) {
+            for(int v = begin; v < end; v++) {
+                ids[v] = result[v];
+            }
+        });
+    }
+
+    /**
+     * Finds the roots of many elements at once. The finds run in order, but each one first
+     * prefetches the first two hops of the finds PREFETCH_DISTANCE and 2 * PREFETCH_DISTANCE
+     * positions later, so on a forest much larger than the cache the misses of upcoming
+     * finds overlap with the current one instead of being waited on one by one.
+     *
+     * @param indices The elements to find.
+     * @param out Receives the root of each element.
+     */
+    void findBatch(const vector<int>& indices, vector<int>& out) {
+        int n = (int) indices.size();
+        out.resize(n);
+        for(int i = 0; i < n; i++) {
+            if(i + 2 * PREFETCH_DISTANCE < n) {
+                prefetchSlot(indices[i + 2 * PREFETCH_DISTANCE]);
+            }
+            if(i + PREFETCH_DISTANCE < n) {
+                prefetchParent(indices[i + PREFETCH_DISTANCE]);
+            }
+            out[i] = find(indices[i]);
+        }
+    }
+
+    /**
+     * Unifies the endpoints of many edges, in order, prefetching the first two hops of the
+     * finds of later edges the same way findBatch does.
+     *
+     * @param edges The (x, y) pairs to unify.
+     */
+    void unifyBatch(const vector<pair<int, int>>& edges) {
+        int n = (int) edges.size();
+        for(int e = 0; e < n; e++) {
+            if(e + 2 * PREFETCH_DISTANCE < n) {
+                prefetchSlot(edges[e + 2 * PREFETCH_DISTANCE].first);
+                prefetchSlot(edges[e + 2 * PREFETCH_DISTANCE].second);
+            }
+            if(e + PREFETCH_DISTANCE < n) {
+                prefetchParent(edges[e + PREFETCH_DISTANCE].first);
+                prefetchParent(edges[e + PREFETCH_DISTANCE].second);
+            }
+            unify(edges[e].first, edges[e].second);
+        }
+    }
+};
+
+// CompactUnionFind class: one int per element and one pass per find. A non-negative slot
+// holds the parent; a root holds minus the size of its component, so union by size needs
+// no second array and every hop touches a single cache line. The element count is not
+// fixed: add() appends a new singleton with amortized O(1) growth of the parent array.
+class CompactUnionFind {
+    private:
+    int* parents;               // Parent of each element, or -size for a root
+    int componentsCount = 0;    // Count of total components
+    int count = 0;              // Count of total elements
+    int capacity = 0;           // Allocated length of parents
+
+    // Move the parent array to a new allocation of the given length
+    void grow(int newCapacity) {
+        int* bigger = new int[newCapacity];
+        for(int i = 0; i < count; i++) {
+            bigger[i] = parents[i];
+        }
+        delete[] parents;
+        parents = bigger;
+        capacity = newCapacity;
+    }
+
+    public:
+    // Constructor to initialize the CompactUnionFind object with _count singletons
+    CompactUnionFind(int _count = 0) {
+        count = componentsCount = capacity = _count;
+        parents = (count > 0) ? new int[count] : nullptr;
+
+        for(int i = 0; i < count; i++) {
+            parents[i] = -1;
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~CompactUnionFind() {
+        delete[] parents;
+    }
+
+    CompactUnionFind(const CompactUnionFind&) = delete;
+    CompactUnionFind& operator=(const CompactUnionFind&) = delete;
+
+    // Append a new singleton element and return its index
+    int add() {
+        if(count == capacity) {
+            grow(max(16, 2 * capacity));
+        }
+        parents[count] = -1;
+        componentsCount++;
+        return count++;
+    }
+
+    // Reserve room for n elements so the next adds do not reallocate
+    void reserve(int n) {
+        if(n > capacity) {
+            grow(n);
+        }
+    }
+
+    // Find the root of the given element with path halving: every other element on the
+    // path is pointed at its grandparent during the single walk up
+    int find(int index) {
+        while(parents[index] >= 0) {
+            int parent = parents[index];
+            if(parents[parent] >= 0) {
+                parents[index] = parents[parent];
+            }
+            index = parents[index];
+        }
+
+        return index;
+    }
+
+    // Check if two elements are connected
+    bool connected(int x, int y) {
+        return (find(x) == find(y));
+    }
+
+    // Get the size of the component containing the given element
+    int componentSize(int x) {
+        return -parents[find(x)];
+    }
+
+    // Get the total number of elements
+    int size() {
+        return count;
+    }
+
+    // Get the total number of components
+    int components() {
+        return componentsCount;
+    }
+
+    // Unify (merge) two components; returns true if they were separate
+    bool unify(int x, int y) {
+        int root1 = find(x);
+        int root2 = find(y);
+
+        if(root1 == root2) {
+            return false;
+        }
+
+        // Merge the smaller component into the larger component (sizes are negative)
+        if(parents[root1] > parents[root2]) {
+            swap(root1, root2);
+        }
+        parents[root1] += parents[root2];
+        parents[root2] = root1;
+
+        componentsCount--;
+        return true;
+    }
+};
+
+// RollbackUnionFind class: union by size without path compression, so every union changes
+// exactly one parent link and can be undone. Each union is logged; snapshot() marks a point
+// in the log and rollback() undoes the unions made after it. find is O(log n).
+class RollbackUnionFind {
+    private:
+    int* sizes;                 // Array to store the size of each component
+    int* ids;                   // Array to store the parent id of each element
+    vector<int> history;        // Root absorbed by each union, in order
+    int componentsCount = 0;    // Count of total components
+    int count = 0;              // Count of total elements
+
+    public:
+    // Constructor to initialize the RollbackUnionFind object
+    RollbackUnionFind(int _count) {
+        count = componentsCount = _count;
+        sizes = new int[count];
+        ids = new int[count];
+
+        for(int i = 0; i < count; i++) {
+            ids[i] = i;
+            sizes[i] = 1;
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~RollbackUnionFind() {
+        delete[] sizes;
+        delete[] ids;
+    }
+
+    RollbackUnionFind(const RollbackUnionFind&) = delete;
+    RollbackUnionFind& operator=(const RollbackUnionFind&) = delete;
+
+    // Find the root of the given element
+    int find(int index) {
+        while(index != ids[index]) {
+            index = ids[index];
+        }
+        return index;
+    }
+
+    // Check if two elements are connected
+    bool connected(int x, int y) {
+        return (find(x) == find(y));
+    }
+
+    // Get the size of the component containing the given element
+    int componentSize(int x) {
+        return sizes[find(x)];
+    }
+
+    // Get the total number of elements
+    int size() {
+        return count;
+    }
+
+    // Get the total number of components
+    int components() {
+        return componentsCount;
+    }
+
+    // Unify (merge) two components; returns true if they were separate
+    bool unify(int x, int y) {
+        int root1 = find(x);
+        int root2 = find(y);
+
+        if(root1 == root2) {
+            return false;
+        }
+
         // Merge the smaller component into the larger component
         if(sizes[root1] < sizes[root2]) {
-            sizes[root2] += sizes[root1];
-            ids[root1] = root2;
-        } else {
-            sizes[root1] += sizes[root2];
-            ids[root2] = root1;
+            swap(root1, root2);
         }
+        sizes[root1] += sizes[root2];
+        ids[root2] = root1;
+        history.push_back(root2);
 
-        // Decrease the component count
         componentsCount--;
+        return true;
+    }
+
+    // Get a marker for the current state, to pass to rollback
+    int snapshot() {
+        return (int) history.size();
+    }
+
+    /**
+     * Undoes every union made since the given snapshot, most recent first.
+     *
+     * @param to A marker returned by snapshot() that has not been rolled back past.
+     */
+    void rollback(int to) {
+        if(to < 0 || to > (int) history.size()) {
+            throw invalid_argument("Invalid snapshot");
+        }
+
+        while((int) history.size() > to) {
+            int child = history.back();
+            history.pop_back();
+            int root = ids[child];
+            sizes[root] -= sizes[child];
+            ids[child] = child;
+            componentsCount++;
+        }
+    }
+};
+
+// OfflineConnectivity class: answers connectivity queries over a sequence of edge additions
+// and removals known in advance. Every edge is alive over an interval of queries; the
+// interval is stored in the O(log q) nodes of a segment tree over the queries that cover it,
+// and a depth-first walk unions the edges of a node on the way down and rolls them back on
+// the way up, so each query leaf sees exactly the edges alive at its time.
+// Total time O(q log q log n) for q events.
+class OfflineConnectivity {
+    private:
+    int count;                                              // Number of elements
+    vector<pair<int, int>> queries;                         // Endpoints of every query, in order
+    vector<pair<pair<int, int>, pair<int, int>>> intervals; // Removed edge and the [first, last) queries it was alive for
+    map<pair<int, int>, vector<int>> open;                  // Live edge -> query counts at which its copies were added
+
+    // Function to check an element index
+    void check(int x) {
+        if(x < 0 || x >= count) {
+            throw out_of_range("Element out of range");
+        }
+    }
+
+    // Function to order the endpoints of an undirected edge
+    static pair<int, int> key(int x, int y) {
+        return make_pair(min(x, y), max(x, y));
+    }
+
+    // Function to store the edge in the nodes covering [from, to) below node [l, r)
+    void insert(vector<vector<pair<int, int>>>& tree, int node, int l, int r, int from, int to, const pair<int, int>& edge) {
+        if(to <= l || r <= from) {
+            return;
+        }
+        if(from <= l && r <= to) {
+            tree[node].push_back(edge);
+            return;
+        }
+        int mid = (l + r) / 2;
+        insert(tree, 2 * node, l, mid, from, to, edge);
+        insert(tree, 2 * node + 1, mid, r, from, to, edge);
+    }
+
+    // Function to walk the tree, answering the queries of every leaf below node [l, r)
+    void walk(vector<vector<pair<int, int>>>& tree, int node, int l, int r, RollbackUnionFind& sets, vector<bool>& answers) {
+        int mark = sets.snapshot();
+        for(auto& edge : tree[node]) {
+            sets.unify(edge.first, edge.second);
+        }
+
+        if(r - l == 1) {
+            answers[l] = sets.connected(queries[l].first, queries[l].second);
+        } else {
+            int mid = (l + r) / 2;
+            walk(tree, 2 * node, l, mid, sets, answers);
+            walk(tree, 2 * node + 1, mid, r, sets, answers);
+        }
+
+        sets.rollback(mark);
+    }
+
+    public:
+    // Constructor for a graph of the given number of elements and no edges
+    OfflineConnectivity(int _count) {
+        count = _count;
+    }
+
+    // Add an edge (parallel edges are allowed and counted separately)
+    void addEdge(int x, int y) {
+        check(x);
+        check(y);
+        open[key(x, y)].push_back((int) queries.size());
+    }
+
+    // Remove one copy of an edge added earlier
+    void removeEdge(int x, int y) {
+        check(x);
+        check(y);
+        auto it = open.find(key(x, y));
+        if(it == open.end()) {
+            throw invalid_argument("Edge is not in the graph");
+        }
+        intervals.push_back(make_pair(it->first, make_pair(it->second.back(), (int) queries.size())));
+        it->second.pop_back();
+        if(it->second.empty()) {
+            open.erase(it);
+        }
+    }
+
+    // Ask whether x and y are connected at this point; returns the index of the query
+    int query(int x, int y) {
+        check(x);
+        check(y);
+        queries.push_back(make_pair(x, y));
+        return (int) queries.size() - 1;
+    }
+
+    /**
+     * Answers every query recorded so far.
+     *
+     * @return answers[i] is true if the endpoints of query i were connected when it was asked.
+     */
+    vector<bool> solve() {
+        int q = (int) queries.size();
+        vector<bool> answers(q);
+        if(q == 0) {
+            return answers;
+        }
+
+        vector<vector<pair<int, int>>> tree(4 * q);
+        for(auto& interval : intervals) {
+            insert(tree, 1, 0, q, interval.second.first, interval.second.second, interval.first);
+        }
+        for(auto& edge : open) {
+            for(int from : edge.second) {
+                insert(tree, 1, 0, q, from, q, edge.first);
+            }
+        }
+
+        RollbackUnionFind sets(count);
+        walk(tree, 1, 0, q, sets, answers);
+        return answers;
+    }
+};
+
+// KeyedUnionFind class: union-find over arbitrary hashable keys (strings, 64-bit ids, ...).
+// Keys are mapped to dense CompactUnionFind indices through a denseKeyMap. add() and unify()
+// insert a key seen for the first time as a new singleton; the queries treat an unknown key
+// as a singleton of its own without inserting it.
+template <typename K, typename Hash = hash<K>>
+class KeyedUnionFind {
+    private:
+    CompactUnionFind sets;          // Union-find over dense indices
+    vector<K> keys;                 // Key of each dense index
+    denseKeyMap<K, Hash> indexOf;   // Key -> dense index
+
+    // Get the dense index of a key, or -1 if it is unknown
+    int lookup(const K& key) {
+        return indexOf.find(key);
+    }
+
+    public:
+    // Constructor to initialize the KeyedUnionFind object with room for about expected keys
+    KeyedUnionFind(int expected = 16) : indexOf(2 * expected) {
+        keys.reserve(expected);
+        sets.reserve(expected);
+    }
+
+    KeyedUnionFind(const KeyedUnionFind&) = delete;
+    KeyedUnionFind& operator=(const KeyedUnionFind&) = delete;
+
+    // Get the dense index of a key, adding it as a new singleton if it is unknown
+    int add(const K& key) {
+        int index = indexOf.findOrInsert(key, sets.size());
+        if(index == sets.size()) {
+            keys.push_back(key);
+            sets.add();
+        }
+        return index;
+    }
+
+    // Check if a key has been seen
+    bool contains(const K& key) {
+        return lookup(key) != -1;
+    }
+
+    // Get the representative key of the component containing key (an unknown key is its own)
+    K find(const K& key) {
+        int index = lookup(key);
+        return index == -1 ? key : keys[sets.find(index)];
+    }
+
+    // Check if two keys are connected (an unknown key is connected only to itself)
+    bool connected(const K& x, const K& y) {
+        int index1 = lookup(x);
+        int index2 = lookup(y);
+        if(index1 == -1 || index2 == -1) {
+            return x == y;
+        }
+        return sets.connected(index1, index2);
+    }
+
+    // Get the size of the component containing the given key (1 for an unknown key)
+    int componentSize(const K& x) {
+        int index = lookup(x);
+        return index == -1 ? 1 : sets.componentSize(index);
+    }
+
+    // Get the total number of keys
+    int size() {
+        return sets.size();
+    }
+
+    // Get the total number of components
+    int components() {
+        return sets.components();
+    }
+
+    // Unify (merge) the components of two keys, adding unknown keys first; returns true if
+    // they were separate
+    bool unify(const K& x, const K& y) {
+        int index1 = add(x);
+        int index2 = add(y);
+        return sets.unify(index1, index2);
+    }
+};
+
+// ConcurrentUnionFind class: a lock-free union-find that many threads can use at once.
+// Parents are atomic words; find() does path splitting with CAS and unify() links one root
+// under the other with a single CAS, retrying if another thread changed the root first.
+// Roots are linked by a fixed random priority per element, which keeps trees shallow
+// without size or rank fields (randomized linking, as in Jayanti-Tarjan).
+class ConcurrentUnionFind {
+    private:
+    atomic<int>* ids;                   // Array to store the parent id of each element
+    atomic<int> componentsCount;        // Count of total components
+    int count = 0;                      // Count of total elements
+
+    // Fixed pseudo random priority of an element, ties broken by index
+    static unsigned int priority(int index) {
+        unsigned int h = (unsigned int) index * 0x9E3779B1u;
+        h ^= h >> 15;
+        h *= 0x85EBCA77u;
+        h ^= h >> 13;
+        return h;
+    }
+
+    // Check if root a links below root b
+    static bool linksBelow(int a, int b) {
+        unsigned int pa = priority(a), pb = priority(b);
+        return pa < pb || (pa == pb && a < b);
+    }
+
+    public:
+    // Constructor to initialize the ConcurrentUnionFind object
+    ConcurrentUnionFind(int _count) : componentsCount(_count) {
+        count = _count;
+        ids = new atomic<int>[count];
+
+        for(int i = 0; i < count; i++) {
+            ids[i].store(i, memory_order_relaxed);
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~ConcurrentUnionFind() {
+        delete[] ids;
+    }
+
+    ConcurrentUnionFind(const ConcurrentUnionFind&) = delete;
+    ConcurrentUnionFind& operator=(const ConcurrentUnionFind&) = delete;
+
+    // Find the root of the given element, splitting the path on the way: every visited
+    // element is pointed at its grandparent with a CAS (a failed CAS means another thread
+    // already shortened the path, so it is simply skipped)
+    int find(int index) {
+        while(true) {
+            int parent = ids[index].load(memory_order_acquire);
+            int grandparent = ids[parent].load(memory_order_acquire);
+            if(parent == grandparent) {
+                return parent;
+            }
+            ids[index].compare_exchange_weak(parent, grandparent, memory_order_release, memory_order_relaxed);
+            index = parent;
+        }
+    }
+
+    // Check if two elements are connected; linearizable: the answer "no" is only
+    // returned while the root of x is still a root
+    bool connected(int x, int y) {
+        while(true) {
+            int root1 = find(x);
+            int root2 = find(y);
+            if(root1 == root2) {
+                return true;
+            }
+            if(ids[root1].load(memory_order_acquire) == root1) {
+                return false;
+            }
+        }
+    }
+
+    // Unify (merge) two components; returns true if this call merged them
+    bool unify(int x, int y) {
+        while(true) {
+            int root1 = find(x);
+            int root2 = find(y);
+            if(root1 == root2) {
+                return false;
+            }
+
+            if(linksBelow(root2, root1)) {
+                swap(root1, root2);
+            }
+
+            // root1 links below root2, but only if root1 is still a root
+            int expected = root1;
+            if(ids[root1].compare_exchange_strong(expected, root2, memory_order_acq_rel)) {
+                componentsCount.fetch_sub(1, memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    // Get the total number of elements
+    int size() {
+        return count;
+    }
+
+    // Get the total number of components
+    int components() {
+        return componentsCount.load(memory_order_relaxed);
+    }
+
+    /**
+     * Labels every element with its component number in 0..k-1, in parallel. Call it once all
+     * unions are done. Components are numbered in the order of their root's index. Apart from
+     * the output, the only memory used is the parent array: every element is first pointed
+     * straight at its root (the union-find stays valid), then out is used as scratch space for
+     * the sizes before it receives the final labels.
+     *
+     * @param out Array of size() entries receiving the labels.
+     * @param histogram Receives component size -> number of components of that size.
+     * @param threads Number of worker threads.
+     * @return The number of components k.
+     */
+    int compactLabels(unsigned int* out, map<int, long long>& histogram, int threads) {
+        threads = max(1, threads);
+        vector<int> rootsInRange(threads, 0);
+        vector<map<int, long long>> partialHistograms(threads);
+
+        // Pass 1: flatten every element onto its root and clear the size counters
+        parallelFor(threads, count, [this, out](int begin, int end, int) {
+            for(int v = begin; v < end; v++) {
+                ids[v].store(find(v), memory_order_relaxed);
+                out[v] = 0;
+            }
+        });
+
+        // Pass 2: count the size of every component at its root
+        parallelFor(threads, count, [this, out](int begin, int end, int) {
+            for(int v = begin; v < end; v++) {
+                __atomic_fetch_add(&out[ids[v].load(memory_order_relaxed)], 1u, __ATOMIC_RELAXED);
+            }
+        });
+
+        // Pass 3: histogram of the sizes and number of roots per thread range
+        parallelFor(threads, count, [this, out, &rootsInRange, &partialHistograms](int begin, int end, int t) {
+            for(int v = begin; v < end; v++) {
+                if(ids[v].load(memory_order_relaxed) == v) {
+                    partialHistograms[t][out[v]]++;
+                    rootsInRange[t]++;
+                }
+            }
+        });
+
+        vector<int> firstLabel(threads, 0);
+        for(int t = 1; t < threads; t++) {
+            firstLabel[t] = firstLabel[t - 1] + rootsInRange[t - 1];
+        }
+        histogram.clear();
+        for(auto& partial : partialHistograms) {
+            for(auto& entry : partial) {
+                histogram[entry.first] += entry.second;
+            }
+        }
+
+        // Pass 4: number the roots
+        parallelFor(threads, count, [this, out, &firstLabel](int begin, int end, int t) {
+            unsigned int label = firstLabel[t];
+            for(int v = begin; v < end; v++) {
+                if(ids[v].load(memory_order_relaxed) == v) {
+                    out[v] = label++;
+                }
+            }
+        });
+
+        // Pass 5: every other element copies the label of its root (roots are not written here)
+        parallelFor(threads, count, [this, out](int begin, int end, int) {
+            for(int v = begin; v < end; v++) {
+                int root = ids[v].load(memory_order_relaxed);
+                if(root != v) {
+                    out[v] = out[root];
+                }
+            }
+        });
+
+        return firstLabel[threads - 1] + rootsInRange[threads - 1];
+    }
+};
+
+/**
+ * Connected components of a binary edge list file. The file is a flat array of
+ * (uint32 from, uint32 to) pairs in native byte order; it is memory mapped and its chunks
+ * are handed to worker threads that union the edges in a ConcurrentUnionFind. The labels
+ * 0..k-1 are written straight into a memory-mapped output file of n uint32 values, so the
+ * only memory used beyond the mapped files is the parent array.
+ *
+ * @param edgePath The binary edge file.
+ * @param n The number of vertices; edges with an endpoint >= n are skipped and counted.
+ * @param labelPath The label file to write.
+ * @param threads Number of worker threads.
+ * @param histogram Receives component size -> number of components of that size.
+ * @param skipped Receives the number of skipped edges.
+ * @return The number of components.
+ */
+int connectedComponentsFromFile(const string& edgePath, int n, const string& labelPath, int threads,
+                                map<int, long long>& histogram, long long& skipped) {
+    const long long CHUNK = 1 << 16;   // Edges per work item
+    threads = max(1, threads);
+    ConcurrentUnionFind sets(n);
+    atomic<long long> nextChunk(0), invalid(0);
+
+    // Union the edges of one chunk
+    auto unionChunk = [&sets, &invalid, n](const unsigned int* edges, long long edgeCount) {
+        long long bad = 0;
+        for(long long e = 0; e < edgeCount; e++) {
+            unsigned int x = edges[2 * e], y = edges[2 * e + 1];
+            if(x >= (unsigned int) n || y >= (unsigned int) n) {
+                bad++;
+                continue;
+            }
+            sets.unify((int) x, (int) y);
+        }
+        invalid += bad;
+    };
+
+#ifndef _WIN32
+    int edgeFile = open(edgePath.c_str(), O_RDONLY);
+    if(edgeFile < 0) {
+        throw runtime_error("Cannot open edge file " + edgePath);
+    }
+    struct stat info;
+    fstat(edgeFile, &info);
+    long long edgeCount = info.st_size / (2 * sizeof(unsigned int));
+    const unsigned int* edges = nullptr;
+    if(edgeCount > 0) {
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, edgeFile, 0);
+        if(mapped == MAP_FAILED) {
+            close(edgeFile);
+            throw runtime_error("Cannot map edge file " + edgePath);
+        }
+        madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+        edges = (const unsigned int*) mapped;
+    }
+
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            while(true) {
+                long long first = nextChunk.fetch_add(CHUNK);
+                if(first >= edgeCount) {
+                    return;
+                }
+                unionChunk(edges + 2 * first, min(CHUNK, edgeCount - first));
+            }
+        });
+    }
+    for(auto& worker : workers) {
+        worker.join();
+    }
+    if(edgeCount > 0) {
+        munmap((void*) edges, info.st_size);
+    }
+    close(edgeFile);
+
+    // Map the output file and label straight into it
+    int labelFile = open(labelPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(labelFile < 0) {
+        throw runtime_error("Cannot create label file " + labelPath);
+    }
+    size_t labelBytes = (size_t) n * sizeof(unsigned int);
+    int components = 0;
+    if(n > 0) {
+        if(ftruncate(labelFile, labelBytes) != 0) {
+            close(labelFile);
+            throw runtime_error("Cannot size label file " + labelPath);
+        }
+        void* mapped = mmap(nullptr, labelBytes, PROT_READ | PROT_WRITE, MAP_SHARED, labelFile, 0);
+        if(mapped == MAP_FAILED) {
+            close(labelFile);
+            throw runtime_error("Cannot map label file " + labelPath);
+        }
+        components = sets.compactLabels((unsigned int*) mapped, histogram, threads);
+        munmap(mapped, labelBytes);
+    } else {
+        histogram.clear();
+    }
+    close(labelFile);
+#else
+    // No mmap: worker threads read fixed-size chunks from a shared stream instead
+    ifstream in(edgePath, ios::binary);
+    if(!in) {
+        throw runtime_error("Cannot open edge file " + edgePath);
+    }
+    mutex readLock;
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            vector<unsigned int> buffer(2 * CHUNK);
+            while(true) {
+                long long edgeCount;
+                {
+                    lock_guard<mutex> guard(readLock);
+                    in.read((char*) buffer.data(), buffer.size() * sizeof(unsigned int));
+                    edgeCount = in.gcount() / (2 * sizeof(unsigned int));
+                }
+                if(edgeCount == 0) {
+                    return;
+                }
+                unionChunk(buffer.data(), edgeCount);
+            }
+        });
+    }
+    for(auto& worker : workers) {
+        worker.join();
+    }
+
+    vector<unsigned int> labels(n);
+    int components = sets.compactLabels(labels.data(), histogram, threads);
+    ofstream out(labelPath, ios::binary);
+    out.write((const char*) labels.data(), labels.size() * sizeof(unsigned int));
+#endif
+
+    skipped = invalid.load();
+    return components;
+}
+
+// Weighted undirected edge
+template <typename W>
+struct WeightedEdge {
+    int from;
+    int to;
+    W weight;
+};
+
+// Map a weight to an unsigned key with the same order, for radix sorting
+template <typename W>
+typename enable_if<is_integral<W>::value, unsigned long long>::type radixKey(W weight) {
+    return (unsigned long long) (long long) weight ^ (is_signed<W>::value ? 1ULL << 63 : 0);
+}
+
+template <typename W>
+typename enable_if<is_floating_point<W>::value, unsigned long long>::type radixKey(W weight) {
+    double value = weight;
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (1ULL << 63);
+}
+
+// Function to sort edges by weight with an LSD radix sort over the 8 bytes of radixKey;
+// the counts of every byte are taken in one pass, and a byte shared by all keys is skipped
+template <typename W>
+void radixSortEdges(WeightedEdge<W>* edges, int n) {
+    if (n < 2) {
+        return;
+    }
+
+    int* count = new int[8 * 256]();
+    for (int e = 0; e < n; e++) {
+        unsigned long long key = radixKey(edges[e].weight);
+        for (int b = 0; b < 8; b++) {
+            count[b * 256 + ((key >> (8 * b)) & 255)]++;
+        }
+    }
+
+    WeightedEdge<W>* buffer = new WeightedEdge<W>[n];
+    WeightedEdge<W>* from = edges, *to = buffer;
+    for (int b = 0; b < 8; b++) {
+        int* byteCount = count + b * 256;
+        if (byteCount[(radixKey(from[0].weight) >> (8 * b)) & 255] == n) {
+            continue;
+        }
+
+        int position = 0;
+        for (int d = 0; d < 256; d++) {
+            int c = byteCount[d];
+            byteCount[d] = position;
+            position += c;
+        }
+        for (int e = 0; e < n; e++) {
+            to[byteCount[(radixKey(from[e].weight) >> (8 * b)) & 255]++] = from[e];
+        }
+        swap(from, to);
+    }
+
+    // The sorted edges may have ended up in the buffer
+    if (from != edges) {
+        copy(from, from + n, edges);
+    }
+    delete[] buffer;
+    delete[] count;
+}
+
+// FilterKruskal class: minimum spanning forest by filter-Kruskal. Edges are split around a
+// sampled pivot weight; the light half is solved first, then heavy edges whose endpoints the
+// light half already connected are filtered out before the heavy half is solved. Small
+// pieces are radix sorted on their weight and fed to UnionFind::unify in order.
+template <typename W>
+class FilterKruskal {
+public:
+    // Type of the forest weight: integral weights are summed in long long so that a forest
+    // of many edges cannot overflow W
+    typedef typename conditional<is_integral<W>::value, long long, W>::type Sum;
+
+private:
+    static const int BASE_CASE = 1 << 14;       // Pieces this small are sorted directly
+    static const int PARALLEL_CUTOFF = 1 << 16; // Pieces this small are partitioned on one thread
+
+    int vertices;                     // Number of vertices
+    int threads;                      // Number of worker threads for partitioning and filtering
+    UnionFind* sets = nullptr;        // Components of the forest built so far
+    vector<WeightedEdge<W>> chosen;   // Edges of the forest
+    vector<WeightedEdge<W>> scratch;  // Buffer for stable partitioning
+    vector<unsigned char> keepFlags;  // Partition predicate of every edge
+    Sum total = Sum();                // Total weight of the forest
+    unsigned int seed = 12345;        // Pivot sampling state
+
+    // Run body(begin, end, thread) over [0, n), on the calling thread when n is small
+    template <typename F>
+    void forRanges(int n, int& used, F body) {
+        used = (n < PARALLEL_CUTOFF) ? 1 : threads;
+        if(used == 1) {
+            body(0, n, 0);
+        } else {
+            parallelFor(used, n, body);
+        }
+    }
+
+    // Stable partition of edges[0, n) moving the edges that satisfy keep to the front;
+    // returns their count. Every range evaluates keep once per edge and counts its kept
+    // edges, the counts are prefix summed and every range scatters into the scratch buffer,
+    // which is then copied back.
+    template <typename Keep>
+    int partition(WeightedEdge<W>* edges, int n, Keep keep) {
+        vector<int> kept(threads + 1, 0);
+        unsigned char* flags = keepFlags.data();
+        int used;
+        forRanges(n, used, [edges, flags, &kept, &keep](int begin, int end, int t) {
+            int c = 0;
+            for(int e = begin; e < end; e++) {
+                flags[e] = keep(edges[e]);
+                c += flags[e];
+            }
+            kept[t] = c;
+        });
+
+        vector<int> keptStart(used), droppedStart(used);
+        int keptTotal = 0;
+        for(int t = 0; t < used; t++) {
+            keptStart[t] = keptTotal;
+            keptTotal += kept[t];
+        }
+        for(int t = 0; t < used; t++) {
+            int begin = (int) ((long long) n * t / used);
+            droppedStart[t] = keptTotal + (begin - keptStart[t]);
+        }
+
+        WeightedEdge<W>* buffer = scratch.data();
+        forRanges(n, used, [edges, buffer, flags, &keptStart, &droppedStart](int begin, int end, int t) {
+            int k = keptStart[t], d = droppedStart[t];
+            for(int e = begin; e < end; e++) {
+                if(flags[e]) {
+                    buffer[k++] = edges[e];
+                } else {
+                    buffer[d++] = edges[e];
+                }
+            }
+        });
+        forRanges(n, used, [edges, buffer](int begin, int end, int) {
+            copy(buffer + begin, buffer + end, edges + begin);
+        });
+        return keptTotal;
+    }
+
+    // Plain Kruskal on a small piece: radix sort by weight, then unify in order
+    void kruskal(WeightedEdge<W>* edges, int n) {
+        radixSortEdges(edges, n);
+        for(int e = 0; e < n && sets->components() > 1; e++) {
+            int root1 = sets->find(edges[e].from);
+            int root2 = sets->find(edges[e].to);
+            if(root1 != root2) {
+                sets->unify(root1, root2);
+                chosen.push_back(edges[e]);
+                total += edges[e].weight;
+            }
+        }
+    }
+
+    // Median of a few sampled weights
+    W samplePivot(WeightedEdge<W>* edges, int n) {
+        W sample[31];
+        for(int i = 0; i < 31; i++) {
+            seed = seed * 1103515245u + 12345u;
+            sample[i] = edges[(seed >> 4) % n].weight;
+        }
+        nth_element(sample, sample + 15, sample + 31);
+        return sample[15];
+    }
+
+    // Filter-Kruskal on edges[0, n)
+    void solve(WeightedEdge<W>* edges, int n) {
+        if(n <= BASE_CASE) {
+            kruskal(edges, n);
+            return;
+        }
+
+        W pivot = samplePivot(edges, n);
+        int light = partition(edges, n, [pivot](const WeightedEdge<W>& edge) {
+            return !(pivot < edge.weight);
+        });
+        if(light == n) {
+            // The pivot is the largest weight: split off the edges strictly below it instead
+            light = partition(edges, n, [pivot](const WeightedEdge<W>& edge) {
+                return edge.weight < pivot;
+            });
+            if(light == 0) {
+                kruskal(edges, n);    // Every weight is equal
+                return;
+            }
+        }
+
+        solve(edges, light);
+        if(sets->components() == 1) {
+            return;
+        }
+
+        // No unions happen while filtering, so the read-only root lookup is safe in parallel
+        UnionFind* components = sets;
+        int heavy = partition(edges + light, n - light, [components](const WeightedEdge<W>& edge) {
+            return components->root(edge.from) != components->root(edge.to);
+        });
+        solve(edges + light, heavy);
+    }
+
+public:
+    // Constructor for the FilterKruskal class
+    FilterKruskal(int _vertices, int _threads = 1) {
+        vertices = _vertices;
+        threads = max(1, _threads);
+    }
+
+    /**
+     * Computes a minimum spanning forest. The edge list is reordered in place.
+     *
+     * @param edges The edges of the graph; endpoints must be in [0, vertices).
+     * @return The total weight of the forest.
+     */
+    Sum run(vector<WeightedEdge<W>>& edges) {
+        for(auto& edge : edges) {
+            if(edge.from < 0 || edge.from >= vertices || edge.to < 0 || edge.to >= vertices) {
+                throw out_of_range("Edge endpoint out of range");
+            }
+        }
+
+        UnionFind components(vertices);
+        sets = &components;
+        chosen.clear();
+        scratch.resize(edges.size());
+        keepFlags.resize(edges.size());
+        total = Sum();
+        solve(edges.data(), (int) edges.size());
+        sets = nullptr;
+        vector<WeightedEdge<W>>().swap(scratch);
+        vector<unsigned char>().swap(keepFlags);
+        return total;
+    }
+
+    // Get the edges of the last computed forest
+    const vector<WeightedEdge<W>>& forest() {
+        return chosen;
+    }
+
+    // Get the number of trees in the last computed forest
+    int components() {
+        return vertices - (int) chosen.size();
+    }
+};
+
+// GridLabeller class: connected-component labelling of a binary raster with the two-pass
+// SAUF scan. The first pass labels each pixel from its already scanned neighbours with a
+// decision tree that reads as few of them as possible, recording label equivalences in a
+// compact union-find over the provisional labels (every root is the smallest label of its
+// set). The image is cut into horizontal strips scanned in parallel, each with its own
+// label range; the strips are then joined along their boundary rows, the provisional
+// labels are flattened to consecutive numbers and the second pass relabels every pixel.
+// The union-find over the labels is its own rather than a CompactUnionFind per strip because
+// the flattening depends on min-label roots: one increasing sweep numbers the regions, and it
+// only works if every label points at a smaller, already numbered one. Union by size picks
+// whichever root is larger. The same array then serves as the relabel table, and its unsigned
+// labels reach past the int range of CompactUnionFind.
+class GridLabeller {
+    private:
+    int threads;                    // Number of strips scanned in parallel
+    bool eightConnected;            // 8-connectivity if true, 4-connectivity otherwise
+    vector<unsigned int> parents;   // Parent of each provisional label (a root is its own parent)
+
+    // Find the root label of a provisional label
+    unsigned int findLabel(unsigned int label) {
+        while(parents[label] < label) {
+            label = parents[label];
+        }
+        return label;
+    }
+
+    // Point every label on the path from label at root
+    void setRoot(unsigned int label, unsigned int root) {
+        while(parents[label] < label) {
+            unsigned int next = parents[label];
+            parents[label] = root;
+            label = next;
+        }
+        parents[label] = root;
+    }
+
+    // Merge the sets of two labels under the smaller root; returns that root
+    unsigned int mergeLabels(unsigned int x, unsigned int y) {
+        unsigned int root = findLabel(x);
+        if(x != y) {
+            unsigned int other = findLabel(y);
+            if(other < root) {
+                root = other;
+            }
+            setRoot(y, root);
+        }
+        setRoot(x, root);
+        return root;
+    }
+
+    // Upper bound on the provisional labels of a strip of the given height: in 8-connectivity
+    // no 2x2 block holds two new labels, in 4-connectivity no horizontal pair does
+    long long labelsBound(int height, int cols) {
+        if(eightConnected) {
+            return (long long) ((height + 1) / 2) * ((cols + 1) / 2);
+        }
+        return (long long) height * ((cols + 1) / 2);
+    }
+
+    // First pass over rows [begin, end), creating labels from next on; returns the next unused label
+    unsigned int scanStrip(const unsigned char* image, int cols, int begin, int end, unsigned int next, unsigned int* out) {
+        for(int r = begin; r < end; r++) {
+            const unsigned char* row = image + (long long) r * cols;
+            const unsigned char* up = (r > begin) ? row - cols : nullptr;
+            unsigned int* labelRow = out + (long long) r * cols;
+            unsigned int* labelUp = labelRow - cols;
+
+            for(int c = 0; c < cols; c++) {
+                if(!row[c]) {
+                    labelRow[c] = 0;
+                    continue;
+                }
+
+                bool hasLeft = c > 0 && row[c - 1];
+                if(!eightConnected) {
+                    bool hasUp = up != nullptr && up[c];
+                    if(hasUp && hasLeft) {
+                        labelRow[c] = mergeLabels(labelUp[c], labelRow[c - 1]);
+                    } else if(hasUp) {
+                        labelRow[c] = labelUp[c];
+                    } else if(hasLeft) {
+                        labelRow[c] = labelRow[c - 1];
+                    } else {
+                        parents[next] = next;
+                        labelRow[c] = next++;
+                    }
+                    continue;
+                }
+
+                // Neighbours: a up-left, b up, c up-right, d left
+                if(up != nullptr && up[c]) {
+                    labelRow[c] = labelUp[c];
+                } else if(up != nullptr && c + 1 < cols && up[c + 1]) {
+                    if(c > 0 && up[c - 1]) {
+                        labelRow[c] = mergeLabels(labelUp[c + 1], labelUp[c - 1]);
+                    } else if(hasLeft) {
+                        labelRow[c] = mergeLabels(labelUp[c + 1], labelRow[c - 1]);
+                    } else {
+                        labelRow[c] = labelUp[c + 1];
+                    }
+                } else if(up != nullptr && c > 0 && up[c - 1]) {
+                    labelRow[c] = labelUp[c - 1];
+                } else if(hasLeft) {
+                    labelRow[c] = labelRow[c - 1];
+                } else {
+                    parents[next] = next;
+                    labelRow[c] = next++;
+                }
+            }
+        }
+        return next;
+    }
+
+    // Merge the labels of row r with those of row r - 1 across a strip boundary
+    void joinRows(const unsigned char* image, int cols, int r, const unsigned int* out) {
+        const unsigned char* row = image + (long long) r * cols;
+        const unsigned char* up = row - cols;
+        const unsigned int* labelRow = out + (long long) r * cols;
+        const unsigned int* labelUp = labelRow - cols;
+
+        for(int c = 0; c < cols; c++) {
+            if(!row[c]) {
+                continue;
+            }
+            if(up[c]) {
+                mergeLabels(labelRow[c], labelUp[c]);
+            } else if(eightConnected) {
+                if(c > 0 && up[c - 1]) {
+                    mergeLabels(labelRow[c], labelUp[c - 1]);
+                }
+                if(c + 1 < cols && up[c + 1]) {
+                    mergeLabels(labelRow[c], labelUp[c + 1]);
+                }
+            }
+        }
+    }
+
+    public:
+    // Constructor for the GridLabeller class
+    GridLabeller(int _threads = 1, bool _eightConnected = true) {
+        threads = max(1, _threads);
+        eightConnected = _eightConnected;
+    }
+
+    /**
+     * Labels the connected foreground regions of an image. Regions are numbered 1..k in the
+     * row-major order of their first pixel; background pixels get 0.
+     *
+     * @param image Row-major pixels, non-zero meaning foreground.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param out Row-major output of rows * cols labels.
+     * @return The number of regions k.
+     */
+    unsigned int label(const unsigned char* image, int rows, int cols, unsigned int* out) {
+        if(rows <= 0 || cols <= 0) {
+            return 0;
+        }
+
+        int strips = min(threads, rows);
+        vector<int> firstRow(strips + 1);
+        vector<unsigned int> firstLabel(strips), endLabel(strips);
+        long long total = 1;    // Label 0 is the background
+        for(int s = 0; s <= strips; s++) {
+            firstRow[s] = (int) ((long long) rows * s / strips);
+        }
+        for(int s = 0; s < strips; s++) {
+            firstLabel[s] = (unsigned int) total;
+            total += labelsBound(firstRow[s + 1] - firstRow[s], cols);
+        }
+        if(total > (long long) numeric_limits<unsigned int>::max()) {
+            throw length_error("Image has too many provisional labels");
+        }
+        parents.assign(total, 0);
+
+        // First pass: every strip on its own, with its own label range
+        parallelFor(strips, strips, [&](int begin, int end, int) {
+            for(int s = begin; s < end; s++) {
+                endLabel[s] = scanStrip(image, cols, firstRow[s], firstRow[s + 1], firstLabel[s], out);
+            }
+        });
+
+        // Join the strips along their boundaries
+        for(int s = 1; s < strips; s++) {
+            joinRows(image, cols, firstRow[s], out);
+        }
+
+        // Flatten: roots get consecutive numbers in label order, other labels copy their root's
+        unsigned int regions = 0;
+        parents[0] = 0;
+        for(int s = 0; s < strips; s++) {
+            for(unsigned int l = firstLabel[s]; l < endLabel[s]; l++) {
+                if(parents[l] < l) {
+                    parents[l] = parents[parents[l]];
+                } else {
+                    parents[l] = ++regions;
+                }
+            }
+        }
+
+        // Second pass: relabel every pixel
+        unsigned int* relabel = parents.data();
+        parallelFor(strips, rows, [out, relabel, cols](int begin, int end, int) {
+            for(long long p = (long long) begin * cols; p < (long long) end * cols; p++) {
+                out[p] = relabel[out[p]];
+            }
+        });
+
+        return regions;
     }
 };
 
+/**
+ * Scaling benchmark: unions edges random edges over n elements with 1, 2, 4 and 8 threads,
+ * each thread taking an interleaved share of the edge list, against the sequential UnionFind
+ * and CompactUnionFind.
+ */
+void concurrentUnionFindBenchmark(int n, int edges) {
+    vector<pair<int, int>> edgeList(edges);
+    unsigned int seed = 2023;
+    for (auto& edge : edgeList) {
+        seed = seed * 1103515245u + 12345u;
+        edge.first = (seed >> 4) % n;
+        seed = seed * 1103515245u + 12345u;
+        edge.second = (seed >> 4) % n;
+    }
+
+    auto start = chrono::steady_clock::now();
+    UnionFind sequential(n);
+    for (auto& edge : edgeList) {
+        sequential.unify(edge.first, edge.second);
+    }
+    chrono::duration<double> sequentialTime = chrono::steady_clock::now() - start;
+    cout << "UnionFind (sequential): " << sequentialTime.count() << "s" << endl;
+
+    start = chrono::steady_clock::now();
+    CompactUnionFind compact(n);
+    for (auto& edge : edgeList) {
+        compact.unify(edge.first, edge.second);
+    }
+    chrono::duration<double> compactTime = chrono::steady_clock::now() - start;
+    assert(compact.components() == sequential.components());
+    cout << "CompactUnionFind (sequential): " << compactTime.count() << "s" << endl;
+
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        ConcurrentUnionFind concurrent(n);
+        start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&concurrent, &edgeList, threads, t]() {
+                for (size_t e = t; e < edgeList.size(); e += threads) {
+                    concurrent.unify(edgeList[e].first, edgeList[e].second);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        assert(concurrent.components() == sequential.components());
+        cout << "ConcurrentUnionFind, " << threads << " threads: " << elapsed.count() << "s" << endl;
+    }
+}
+
+/**
+ * Batch benchmark on a random graph much larger than the last level cache (n = 2^26 takes
+ * 768MB of UnionFind arrays per forest): unify one edge at a time vs unifyBatch, then find
+ * one element at a time vs findBatch.
+ */
+void batchUnionFindBenchmark(int n, int edges) {
+    vector<pair<int, int>> edgeList(edges);
+    vector<int> queries(edges);
+    unsigned int seed = 404;
+    for (int e = 0; e < edges; e++) {
+        seed = seed * 1103515245u + 12345u;
+        edgeList[e].first = (seed >> 4) % n;
+        seed = seed * 1103515245u + 12345u;
+        edgeList[e].second = (seed >> 4) % n;
+        seed = seed * 1103515245u + 12345u;
+        queries[e] = (seed >> 4) % n;
+    }
+
+    UnionFind single(n), batched(n);
+    auto start = chrono::steady_clock::now();
+    for (auto& edge : edgeList) {
+        single.unify(edge.first, edge.second);
+    }
+    chrono::duration<double> singleUnify = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    batched.unifyBatch(edgeList);
+    chrono::duration<double> batchUnify = chrono::steady_clock::now() - start;
+    assert(single.components() == batched.components());
+
+    vector<int> singleRoots(edges), batchRoots;
+    start = chrono::steady_clock::now();
+    for (int e = 0; e < edges; e++) {
+        singleRoots[e] = single.find(queries[e]);
+    }
+    chrono::duration<double> singleFind = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    batched.findBatch(queries, batchRoots);
+    chrono::duration<double> batchFind = chrono::steady_clock::now() - start;
+    for (int e = 0; e < edges; e += 1009) {
+        assert(batched.componentSize(batchRoots[e]) == single.componentSize(singleRoots[e]));
+    }
+
+    cout << "unify: per edge " << singleUnify.count() << "s, unifyBatch " << batchUnify.count() << "s" << endl;
+    cout << "find: per element " << singleFind.count() << "s, findBatch " << batchFind.count() << "s" << endl;
+}
+
+/**
+ * MST benchmark on a random graph: comparison-sorted Kruskal against filter-Kruskal
+ * on 1, 2 and 4 threads.
+ */
+void filterKruskalBenchmark(int n, int edges) {
+    vector<WeightedEdge<int>> edgeList(edges);
+    unsigned int seed = 77;
+    for (auto& edge : edgeList) {
+        seed = seed * 1103515245u + 12345u;
+        edge.from = (seed >> 4) % n;
+        seed = seed * 1103515245u + 12345u;
+        edge.to = (seed >> 4) % n;
+        seed = seed * 1103515245u + 12345u;
+        edge.weight = (seed >> 4) % 1000000;
+    }
+
+    vector<WeightedEdge<int>> sorted = edgeList;
+    auto start = chrono::steady_clock::now();
+    sort(sorted.begin(), sorted.end(), [](const WeightedEdge<int>& a, const WeightedEdge<int>& b) {
+        return a.weight < b.weight;
+    });
+    UnionFind sets(n);
+    long long expected = 0;
+    for (auto& edge : sorted) {
+        if (!sets.connected(edge.from, edge.to)) {
+            sets.unify(edge.from, edge.to);
+            expected += edge.weight;
+        }
+    }
+    chrono::duration<double> kruskalTime = chrono::steady_clock::now() - start;
+    cout << "Kruskal (std::sort): " << kruskalTime.count() << "s" << endl;
+
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        vector<WeightedEdge<int>> input = edgeList;
+        FilterKruskal<int> mst(n, threads);
+        start = chrono::steady_clock::now();
+        long long total = mst.run(input);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        assert(total == expected);
+        long long weight = 0;
+        for (auto& edge : mst.forest()) {
+            weight += edge.weight;
+        }
+        assert(weight == expected);
+        cout << "FilterKruskal, " << threads << " threads: " << elapsed.count() << "s" << endl;
+    }
+}
+
+/**
+ * Labelling benchmark on a random binary image: one UnionFind::unify per neighbouring pair
+ * of foreground pixels against GridLabeller on 1, 2 and 4 strips.
+ */
+void gridLabellingBenchmark(int rows, int cols) {
+    vector<unsigned char> image((long long) rows * cols);
+    unsigned int seed = 8;
+    for (auto& pixel : image) {
+        seed = seed * 1103515245u + 12345u;
+        pixel = ((seed >> 8) % 100) < 55;
+    }
+
+    auto start = chrono::steady_clock::now();
+    UnionFind pixels(rows * cols);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int p = r * cols + c;
+            if (!image[p]) {
+                continue;
+            }
+            if (c > 0 && image[p - 1]) {
+                pixels.unify(p, p - 1);
+            }
+            if (r > 0) {
+                for (int q = max(0, c - 1); q <= min(cols - 1, c + 1); q++) {
+                    if (image[p - cols - c + q]) {
+                        pixels.unify(p, p - cols - c + q);
+                    }
+                }
+            }
+        }
+    }
+    chrono::duration<double> unifyTime = chrono::steady_clock::now() - start;
+    int background = 0;
+    for (unsigned char pixel : image) {
+        background += !pixel;
+    }
+    cout << "UnionFind per pixel: " << unifyTime.count() << "s" << endl;
+
+    vector<unsigned int> labels((long long) rows * cols);
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        GridLabeller labeller(threads);
+        start = chrono::steady_clock::now();
+        unsigned int regions = labeller.label(image.data(), rows, cols, labels.data());
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        assert((int) regions == pixels.components() - background);
+        cout << "GridLabeller, " << threads << " strips: " << elapsed.count() << "s" << endl;
+    }
+}
+
 int main() {
     // Test case 1: Testing initialization of UnionFind objects
     UnionFind uf1(5);
@@ -121,6 +1715,410 @@ int main() {
     assert(uf1.componentSize(1) == 2);
     assert(uf1.components() == 4);
 
+    // Test case 6: ConcurrentUnionFind on one thread
+    ConcurrentUnionFind cuf1(5);
+    assert(cuf1.size() == 5 && cuf1.components() == 5);
+    assert(cuf1.unify(1, 3));
+    assert(!cuf1.unify(3, 1));
+    assert(cuf1.connected(1, 3) && !cuf1.connected(1, 4));
+    cuf1.unify(3, 4);
+    assert(cuf1.find(4) == cuf1.find(1));
+    assert(cuf1.components() == 3);
+
+    // Test case 7: Concurrent unions from many threads agree with the sequential UnionFind
+    int ringSize = 100000;
+    ConcurrentUnionFind cuf2(ringSize);
+    UnionFind uf2(ringSize);
+    vector<thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&cuf2, ringSize, t]() {
+            // Every thread links its own residue class of a ring of stride 7
+            for (int i = t; i < ringSize; i += 4) {
+                if (i % 7 != 0) {
+                    cuf2.unify(i, (i + 7) % ringSize);
+                }
+                cuf2.find(ringSize - 1 - i);
+            }
+        });
+    }
+    for (int i = 0; i < ringSize; i++) {
+        if (i % 7 != 0) {
+            uf2.unify(i, (i + 7) % ringSize);
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    assert(cuf2.components() == uf2.components());
+    for (int i = 0; i < ringSize; i += 97) {
+        assert(cuf2.connected(i, (i + 7 * 13) % ringSize) == uf2.connected(i, (i + 7 * 13) % ringSize));
+    }
+
+    // Test case 8: CompactUnionFind agrees with UnionFind on random unions
+    int compactSize = 10000;
+    CompactUnionFind compact(compactSize);
+    UnionFind reference(compactSize);
+    unsigned int compactSeed = 17;
+    for (int i = 0; i < 8000; i++) {
+        compactSeed = compactSeed * 1103515245u + 12345u;
+        int x = (compactSeed >> 4) % compactSize;
+        compactSeed = compactSeed * 1103515245u + 12345u;
+        int y = (compactSeed >> 4) % compactSize;
+        bool separate = !reference.connected(x, y);
+        assert(compact.unify(x, y) == separate);
+        reference.unify(x, y);
+        assert(compact.componentSize(x) == reference.componentSize(x));
+    }
+    assert(compact.components() == reference.components());
+    for (int i = 0; i < compactSize; i += 31) {
+        assert(compact.connected(i, compactSize - 1 - i) == reference.connected(i, compactSize - 1 - i));
+    }
+
+    // Test case 9: CompactUnionFind grows one element at a time
+    CompactUnionFind dynamic;
+    for (int i = 0; i < 1000; i++) {
+        assert(dynamic.add() == i);
+        if (i > 0 && i % 10 != 0) {
+            dynamic.unify(i - 1, i);
+        }
+    }
+    assert(dynamic.size() == 1000 && dynamic.components() == 100);
+    assert(dynamic.componentSize(15) == 10 && dynamic.connected(10, 19) && !dynamic.connected(19, 20));
+
+    // Test case 10: KeyedUnionFind over string and 64-bit ids arriving in a stream
+    KeyedUnionFind<string> people;
+    people.unify("alice@example.com", "a.smith");
+    people.unify("bob", "robert");
+    people.unify("a.smith", "alice");
+    assert(people.size() == 5 && people.components() == 2);
+    assert(people.connected("alice", "alice@example.com"));
+    assert(!people.connected("alice", "bob"));
+    assert(people.componentSize("a.smith") == 3);
+    assert(people.find("robert") == people.find("bob"));
+
+    // Queries on an unknown key see a singleton and do not insert it
+    assert(!people.connected("carol", "bob") && people.connected("carol", "carol"));
+    assert(people.componentSize("carol") == 1 && people.find("carol") == "carol");
+    assert(!people.contains("carol") && people.size() == 5 && people.components() == 2);
+    people.add("carol");
+    assert(people.contains("carol") && people.size() == 6 && people.components() == 3);
+
+    KeyedUnionFind<unsigned long long> records(4);
+    unsigned long long recordSeed = 99;
+    vector<unsigned long long> ids;
+    for (int i = 0; i < 20000; i++) {
+        recordSeed = recordSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+        ids.push_back(recordSeed);
+    }
+    for (int i = 1; i < 20000; i++) {
+        if (i % 4 != 0) {
+            records.unify(ids[i - 1], ids[i]);
+        }
+    }
+    assert(records.size() == 20000 && records.components() == 5000);
+    assert(records.connected(ids[4], ids[7]) && !records.connected(ids[7], ids[8]));
+
+    // Test case 11: Batched unions and finds agree with the one-at-a-time versions
+    UnionFind oneByOne(5000), batch(5000);
+    vector<pair<int, int>> batchEdges;
+    unsigned int batchSeed = 8;
+    for (int i = 0; i < 4000; i++) {
+        batchSeed = batchSeed * 1103515245u + 12345u;
+        int x = (batchSeed >> 4) % 5000;
+        batchSeed = batchSeed * 1103515245u + 12345u;
+        batchEdges.push_back({x, (int) ((batchSeed >> 4) % 5000)});
+        oneByOne.unify(batchEdges.back().first, batchEdges.back().second);
+    }
+    batch.unifyBatch(batchEdges);
+    assert(batch.components() == oneByOne.components());
+    vector<int> everyone(5000), roots;
+    for (int i = 0; i < 5000; i++) {
+        everyone[i] = i;
+    }
+    batch.findBatch(everyone, roots);
+    for (int i = 0; i < 5000; i++) {
+        assert(roots[i] == batch.find(i));
+        assert(batch.componentSize(i) == oneByOne.componentSize(i));
+        assert(batch.connected(batchEdges[i % 4000].first, batchEdges[i % 4000].second));
+    }
+
+    // Test case 12: Connected components of a binary edge file
+    const char* edgePath = "UnionFind_edges.bin";
+    const char* labelPath = "UnionFind_labels.bin";
+    int fileVertices = 200000;
+    UnionFind fileReference(fileVertices);
+    {
+        ofstream edgeOut(edgePath, ios::binary);
+        unsigned int fileSeed = 5;
+        for (int e = 0; e < 150000; e++) {
+            fileSeed = fileSeed * 1103515245u + 12345u;
+            unsigned int edge[2] = { (fileSeed >> 4) % fileVertices, 0 };
+            fileSeed = fileSeed * 1103515245u + 12345u;
+            edge[1] = (fileSeed >> 4) % fileVertices;
+            fileReference.unify(edge[0], edge[1]);
+            edgeOut.write((const char*) edge, sizeof(edge));
+        }
+        unsigned int outOfRange[2] = { 1, (unsigned int) fileVertices };
+        edgeOut.write((const char*) outOfRange, sizeof(outOfRange));
+    }
+    map<int, long long> histogram;
+    long long skipped;
+    int labelCount = connectedComponentsFromFile(edgePath, fileVertices, labelPath, 3, histogram, skipped);
+    assert(labelCount == fileReference.components() && skipped == 1);
+
+    vector<unsigned int> fileLabels(fileVertices);
+    {
+        ifstream labelIn(labelPath, ios::binary);
+        labelIn.read((char*) fileLabels.data(), fileVertices * sizeof(unsigned int));
+        assert(labelIn.gcount() == (long long) (fileVertices * sizeof(unsigned int)));
+    }
+    std::remove(edgePath);
+    std::remove(labelPath);
+
+    vector<int> labelOfRoot(fileVertices, -1);
+    vector<long long> labelSizes(labelCount, 0);
+    for (int v = 0; v < fileVertices; v++) {
+        assert(fileLabels[v] < (unsigned int) labelCount);
+        int root = fileReference.find(v);
+        if (labelOfRoot[root] == -1) {
+            labelOfRoot[root] = fileLabels[v];
+        }
+        assert(labelOfRoot[root] == (int) fileLabels[v]);
+        labelSizes[fileLabels[v]]++;
+    }
+    map<int, long long> expectedHistogram;
+    for (long long componentSize : labelSizes) {
+        expectedHistogram[componentSize]++;
+    }
+    assert(histogram == expectedHistogram);
+
+    // Test case 13: Filter-Kruskal matches plain Kruskal on integer and floating point weights
+    unsigned int mstSeed = 13;
+    for (int threads = 1; threads <= 4; threads *= 3) {
+        int mstVertices = 20000;
+        vector<WeightedEdge<int>> intEdges;
+        vector<WeightedEdge<double>> doubleEdges;
+        for (int e = 0; e < 150000; e++) {
+            mstSeed = mstSeed * 1103515245u + 12345u;
+            int from = (mstSeed >> 4) % mstVertices;
+            mstSeed = mstSeed * 1103515245u + 12345u;
+            int to = (mstSeed >> 4) % mstVertices;
+            mstSeed = mstSeed * 1103515245u + 12345u;
+            intEdges.push_back({ from, to, (int) ((mstSeed >> 4) % 2001) - 1000 });
+            doubleEdges.push_back({ from, to, ((int) ((mstSeed >> 4) % 20001) - 10000) / 7.0 });
+        }
+
+        vector<WeightedEdge<int>> sortedInt = intEdges;
+        sort(sortedInt.begin(), sortedInt.end(), [](const WeightedEdge<int>& a, const WeightedEdge<int>& b) {
+            return a.weight < b.weight;
+        });
+        UnionFind kruskalSets(mstVertices);
+        long long expectedInt = 0;
+        for (auto& edge : sortedInt) {
+            if (!kruskalSets.connected(edge.from, edge.to)) {
+                kruskalSets.unify(edge.from, edge.to);
+                expectedInt += edge.weight;
+            }
+        }
+
+        FilterKruskal<int> intMst(mstVertices, threads);
+        long long intWeight = intMst.run(intEdges);
+        assert(intWeight == expectedInt);
+        assert(intMst.components() == kruskalSets.components());
+        UnionFind forestSets(mstVertices);
+        for (auto& edge : intMst.forest()) {
+            assert(!forestSets.connected(edge.from, edge.to));
+            forestSets.unify(edge.from, edge.to);
+        }
+
+        vector<WeightedEdge<double>> sortedDouble = doubleEdges;
+        sort(sortedDouble.begin(), sortedDouble.end(), [](const WeightedEdge<double>& a, const WeightedEdge<double>& b) {
+            return a.weight < b.weight;
+        });
+        UnionFind doubleSets(mstVertices);
+        double expectedDouble = 0;
+        for (auto& edge : sortedDouble) {
+            if (!doubleSets.connected(edge.from, edge.to)) {
+                doubleSets.unify(edge.from, edge.to);
+                expectedDouble += edge.weight;
+            }
+        }
+        FilterKruskal<double> doubleMst(mstVertices, threads);
+        double doubleWeight = doubleMst.run(doubleEdges);
+        assert(fabs(doubleWeight - expectedDouble) < 1e-6 * max(1.0, fabs(expectedDouble)));
+    }
+
+    // Test case 14: Equal weights, a single edge, and int weights summing past INT_MAX
+    vector<WeightedEdge<unsigned int>> equalEdges;
+    for (int e = 0; e < 50000; e++) {
+        equalEdges.push_back({ e % 1000, (e * 7 + 1) % 1000, 3u });
+    }
+    FilterKruskal<unsigned int> equalMst(1000);
+    long long equalWeight = equalMst.run(equalEdges);
+    assert(equalWeight == 3LL * (1000 - equalMst.components()));
+    vector<WeightedEdge<long long>> oneEdge = { { 0, 1, -5 } };
+    FilterKruskal<long long> tinyMst(3);
+    assert(tinyMst.run(oneEdge) == -5 && tinyMst.components() == 2);
+
+    vector<WeightedEdge<int>> heavyEdges = { { 0, 1, 2000000000 }, { 1, 2, 2000000000 }, { 2, 3, 2000000000 } };
+    FilterKruskal<int> heavyMst(4);
+    assert(heavyMst.run(heavyEdges) == 6000000000LL);
+
+    // Test case 15: Rollback to snapshots restores earlier states
+    RollbackUnionFind undo(6);
+    undo.unify(0, 1);
+    int mark1 = undo.snapshot();
+    undo.unify(2, 3);
+    undo.unify(1, 3);
+    assert(!undo.unify(0, 2));
+    assert(undo.componentSize(0) == 4 && undo.components() == 3);
+    int mark2 = undo.snapshot();
+    undo.unify(4, 5);
+    undo.rollback(mark2);
+    assert(!undo.connected(4, 5) && undo.connected(0, 3));
+    undo.rollback(mark1);
+    assert(undo.connected(0, 1) && !undo.connected(1, 2) && !undo.connected(2, 3));
+    assert(undo.components() == 5 && undo.componentSize(1) == 2);
+    bool rollbackThrown = false;
+    try {
+        undo.rollback(mark2);
+    } catch (invalid_argument&) {
+        rollbackThrown = true;
+    }
+    assert(rollbackThrown);
+
+    // Test case 16: Offline dynamic connectivity matches rebuilding from the live edges
+    int dynamicVertices = 60;
+    OfflineConnectivity offline(dynamicVertices);
+    multiset<pair<int, int>> live;
+    vector<bool> expectedAnswers;
+    unsigned int dynamicSeed = 99;
+    for (int step = 0; step < 3000; step++) {
+        dynamicSeed = dynamicSeed * 1103515245u + 12345u;
+        int op = (dynamicSeed >> 16) % 3;
+        dynamicSeed = dynamicSeed * 1103515245u + 12345u;
+        int x = (dynamicSeed >> 4) % dynamicVertices;
+        dynamicSeed = dynamicSeed * 1103515245u + 12345u;
+        int y = (dynamicSeed >> 4) % dynamicVertices;
+        if (op == 0) {
+            offline.addEdge(x, y);
+            live.insert(make_pair(min(x, y), max(x, y)));
+        } else if (op == 1 && !live.empty()) {
+            auto edge = live.begin();
+            advance(edge, (dynamicSeed >> 8) % live.size());
+            offline.removeEdge(edge->second, edge->first);
+            live.erase(edge);
+        } else {
+            assert(offline.query(x, y) == (int) expectedAnswers.size());
+            UnionFind rebuilt(dynamicVertices);
+            for (auto& edge : live) {
+                rebuilt.unify(edge.first, edge.second);
+            }
+            expectedAnswers.push_back(rebuilt.connected(x, y));
+        }
+    }
+    assert(offline.solve() == expectedAnswers);
+    bool removeThrown = false;
+    try {
+        OfflineConnectivity(3).removeEdge(0, 1);
+    } catch (invalid_argument&) {
+        removeThrown = true;
+    }
+    assert(removeThrown);
+
+    // Test case 17: Member enumeration and labels agree with a full scan
+    UnionFind grouped(5000);
+    unsigned int memberSeed = 3;
+    for (int e = 0; e < 3500; e++) {
+        memberSeed = memberSeed * 1103515245u + 12345u;
+        int x = (memberSeed >> 4) % 5000;
+        memberSeed = memberSeed * 1103515245u + 12345u;
+        grouped.unify(x, (memberSeed >> 4) % 5000);
+    }
+    vector<int> groupLabels;
+    grouped.labels(groupLabels, 4);
+    for (int x = 0; x < 5000; x += 7) {
+        vector<int> listed = grouped.members(x);
+        assert(listed[0] == x && (int) listed.size() == grouped.componentSize(x));
+        sort(listed.begin(), listed.end());
+        vector<int> scanned;
+        for (int v = 0; v < 5000; v++) {
+            if (groupLabels[v] == groupLabels[x]) {
+                scanned.push_back(v);
+            }
+        }
+        assert(listed == scanned);
+        assert(groupLabels[x] == grouped.find(x));
+    }
+    UnionFind trio(3);
+    trio.unify(2, 0);
+    assert(trio.members(1) == vector<int>({ 1 }));
+    assert(trio.members(0) == vector<int>({ 0, 2 }) && trio.members(2) == vector<int>({ 2, 0 }));
+    trio.unify(1, 2);   // The member lists exist now and are spliced by the union
+    vector<int> trioMembers = trio.members(1);
+    sort(trioMembers.begin(), trioMembers.end());
+    assert(trioMembers == vector<int>({ 0, 1, 2 }));
+
+    // Test case 18: Grid labelling matches a flood fill in 4 and 8 connectivity, on several strips
+    for (int density = 30; density <= 70; density += 20) {
+        int gridRows = 157, gridCols = 203;
+        vector<unsigned char> image(gridRows * gridCols);
+        unsigned int gridSeed = density;
+        for (auto& pixel : image) {
+            gridSeed = gridSeed * 1103515245u + 12345u;
+            pixel = ((gridSeed >> 8) % 100) < (unsigned int) density;
+        }
+
+        for (int eight = 0; eight <= 1; eight++) {
+            vector<unsigned int> expected(gridRows * gridCols, 0);
+            unsigned int regions = 0;
+            for (int start = 0; start < gridRows * gridCols; start++) {
+                if (!image[start] || expected[start] != 0) {
+                    continue;
+                }
+                expected[start] = ++regions;
+                vector<int> stack(1, start);
+                while (!stack.empty()) {
+                    int p = stack.back();
+                    stack.pop_back();
+                    for (int dr = -1; dr <= 1; dr++) {
+                        for (int dc = -1; dc <= 1; dc++) {
+                            int r = p / gridCols + dr, c = p % gridCols + dc;
+                            if ((dr == 0 && dc == 0) || (!eight && dr != 0 && dc != 0)) {
+                                continue;
+                            }
+                            if (r < 0 || r >= gridRows || c < 0 || c >= gridCols) {
+                                continue;
+                            }
+                            int q = r * gridCols + c;
+                            if (image[q] && expected[q] == 0) {
+                                expected[q] = regions;
+                                stack.push_back(q);
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (int threads = 1; threads <= 7; threads += 3) {
+                GridLabeller labeller(threads, eight == 1);
+                vector<unsigned int> gridLabels(gridRows * gridCols, 12345);
+                assert(labeller.label(image.data(), gridRows, gridCols, gridLabels.data()) == regions);
+                assert(gridLabels == expected);
+            }
+        }
+    }
+    unsigned char oneRow[] = { 1, 0, 1, 1, 0, 1 };
+    unsigned int oneRowLabels[6];
+    assert(GridLabeller(4).label(oneRow, 1, 6, oneRowLabels) == 3);
+    assert(oneRowLabels[0] == 1 && oneRowLabels[3] == 2 && oneRowLabels[4] == 0 && oneRowLabels[5] == 3);
+
+    // Scaling benchmark
+    concurrentUnionFindBenchmark(1 << 21, 1 << 22);
+    batchUnionFindBenchmark(1 << 26, 1 << 26);
+    filterKruskalBenchmark(1 << 20, 1 << 23);
+    gridLabellingBenchmark(4096, 4096);
+
     cout << "All test cases passed!" << endl;
 
     return 0;
@@ -0,0 +1,156 @@
+/*
+    Author: Seif Ibrahim
+    Description: Dense key map shared by the indexed priority queues and the keyed union-find
+
+    Last Updated: 19/10/2026
+
+    Github: Seif-Ibrahim1
+
+*/
+
+#ifndef DENSE_KEY_MAP_H
+#define DENSE_KEY_MAP_H
+
+#include <functional>
+
+// Open-addressing (linear probing) map from arbitrary hashable keys to dense slot numbers
+template <typename K, typename Hash = std::hash<K>>
+class denseKeyMap {
+    K* keys;                // Keys stored in the table
+    int* slots;             // Dense slot of each key (-1 marks an empty bucket)
+    int capacity;           // Number of buckets (a power of two)
+    int count = 0;          // Number of keys stored
+
+    // Function to spread the hash bits over the whole word (std::hash of an integer is the identity)
+    int bucketOf(const K& key) {
+        unsigned long long h = Hash()(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return (int) (h & (capacity - 1));
+    }
+
+    // Function to double the number of buckets and reinsert every key
+    void resize() {
+        K* oldKeys = keys;
+        int* oldSlots = slots;
+        int oldCapacity = capacity;
+
+        capacity *= 2;
+        keys = new K[capacity];
+        slots = new int[capacity];
+        for (int i = 0; i < capacity; i++) {
+            slots[i] = -1;
+        }
+        count = 0;
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldSlots[i] != -1) {
+                insert(oldKeys[i], oldSlots[i]);
+            }
+        }
+
+        delete[] oldKeys;
+        delete[] oldSlots;
+    }
+
+public:
+    // Constructor to initialize the map with room for about _capacity / 2 keys
+    denseKeyMap(int _capacity = 16) {
+        capacity = 16;
+        while (capacity < _capacity) {
+            capacity *= 2;
+        }
+        keys = new K[capacity];
+        slots = new int[capacity];
+        for (int i = 0; i < capacity; i++) {
+            slots[i] = -1;
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~denseKeyMap() {
+        delete[] keys;
+        delete[] slots;
+    }
+
+    denseKeyMap(const denseKeyMap&) = delete;
+    denseKeyMap& operator=(const denseKeyMap&) = delete;
+
+    // Function to get the slot of a key, or -1 if the key is not present
+    int find(const K& key) {
+        for (int i = bucketOf(key); slots[i] != -1; i = (i + 1) & (capacity - 1)) {
+            if (keys[i] == key) {
+                return slots[i];
+            }
+        }
+        return -1;
+    }
+
+    // Function to get the slot of a key, mapping it to slot first if it is not present; one
+    // probe serves both the lookup and the insertion
+    int findOrInsert(const K& key, int slot) {
+        if (2 * (count + 1) > capacity) {
+            resize();
+        }
+
+        int i = bucketOf(key);
+        while (slots[i] != -1) {
+            if (keys[i] == key) {
+                return slots[i];
+            }
+            i = (i + 1) & (capacity - 1);
+        }
+        keys[i] = key;
+        slots[i] = slot;
+        count++;
+        return slot;
+    }
+
+    // Function to map a key (not present yet) to a slot
+    void insert(const K& key, int slot) {
+        if (2 * (count + 1) > capacity) {
+            resize();
+        }
+
+        int i = bucketOf(key);
+        while (slots[i] != -1) {
+            i = (i + 1) & (capacity - 1);
+        }
+        keys[i] = key;
+        slots[i] = slot;
+        count++;
+    }
+
+    // Function to remove a key; later entries of the probe run are shifted back so no tombstones are needed
+    void erase(const K& key) {
+        int i = bucketOf(key);
+        while (slots[i] != -1 && !(keys[i] == key)) {
+            i = (i + 1) & (capacity - 1);
+        }
+        if (slots[i] == -1) {
+            return;
+        }
+
+        slots[i] = -1;
+        count--;
+        for (int j = (i + 1) & (capacity - 1); slots[j] != -1; j = (j + 1) & (capacity - 1)) {
+            int home = bucketOf(keys[j]);
+            // Move the entry at j into the hole at i unless its home lies cyclically in (i, j]
+            bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (!stays) {
+                keys[i] = keys[j];
+                slots[i] = slots[j];
+                slots[j] = -1;
+                i = j;
+            }
+        }
+    }
+
+    // Function to get the number of keys stored
+    int size() {
+        return count;
+    }
+};
+
+#endif
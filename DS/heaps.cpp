@@ -12,6 +12,16 @@
 #include <iostream>
 #include <exception>
 #include <cassert>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <type_traits>
+#include <algorithm>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 using namespace std;
 
 // Custom exception class for out-of-range errors
@@ -75,6 +85,14 @@ public:
         heap = new T[cap];
     }
 
+    // Destructor to deallocate memory
+    ~MinHeap() {
+        delete[] heap;
+    }
+
+    MinHeap(const MinHeap&) = delete;
+    MinHeap& operator=(const MinHeap&) = delete;
+
     // Private helper function to restore heap property from bottom to top
     void heapifyBottomUp(int index) {
         int parent = (index - 1) / 2;
@@ -162,7 +180,6 @@ public:
 
     // Public function to clear the heap
     void clear() {
-        delete[] heap;
         size = 0;
     }
 };
@@ -307,6 +324,879 @@ void HEAP_CHANGE_KEY(T *array, int keyIndex, T newValue) {
 //-------------------------------------------------------------------
 //-------------------------------------------------------------------
 
+//----------------------------------------------------------------
+//--------------------MultiQueue (concurrent)---------------------
+//----------------------------------------------------------------
+/**
+ * Relaxed concurrent priority queue built from c * threads MinHeap shards.
+ * add() pushes into a random shard, extractMin() locks two random shards and pops the smaller top.
+ * Shards are only ever taken with try_lock, so a busy shard is skipped instead of waited on.
+ * Each thread keeps using the shards it picked for STICKINESS operations (or until one is
+ * busy), which saves random numbers and keeps the shards hot in its cache. There is no shared
+ * element counter; emptiness is decided from per-shard sizes.
+ * Pops are not exact: the returned element is close to (but not always) the global minimum.
+ *
+ * @tparam T The type of elements in the queue (must support operator> like MinHeap).
+ */
+template <class T>
+class MultiQueue {
+    static const int STICKINESS = 8;    // Operations a thread runs on the shards it picked
+
+    // One heap per shard, padded to its own cache line so shard locks do not false-share
+    struct alignas(64) Shard {
+        mutex lock;
+        MinHeap<T> heap;
+        atomic<int> size{0};    // Heap size, written under the lock and read without it
+    };
+
+    // Shards a thread is currently sticking to
+    struct Sticky {
+        unsigned long long owner = 0;       // Id of the queue the shard indices belong to
+        unsigned int random = 0;            // xorshift state
+        int addShard = 0, addLeft = 0;      // Shard for add() and the operations left on it
+        int popShards[2] = {0, 0};          // Shard pair for extractMin()
+        int popLeft = 0;                    // Operations left on the pair
+    };
+
+    Shard* shards;              // Array of shards
+    int shardCount;             // Number of shards (c * threads)
+    unsigned long long id;      // Unique id (a queue at a reused address must not inherit sticky state)
+
+    // Private helper function returning a fresh queue id
+    static unsigned long long nextId() {
+        static atomic<unsigned long long> ids{0};
+        return ids.fetch_add(1) + 1;
+    }
+
+    // Private helper function returning the calling thread's sticky state for this queue
+    Sticky& sticky() {
+        static atomic<unsigned int> seeds{0x9E3779B9u};
+        thread_local Sticky state;
+        if (state.owner != id) {
+            state = Sticky();
+            state.owner = id;
+            state.random = seeds.fetch_add(0x6C8E9CF5u) | 1u;
+        }
+        return state;
+    }
+
+    // Private helper function returning a random shard index (xorshift, multiply-shift reduced)
+    int randomShard(Sticky& state) {
+        unsigned int x = state.random;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state.random = x;
+        return (int) (((unsigned long long) x * shardCount) >> 32);
+    }
+
+    // Private helper function to pop from a locked non-empty shard
+    T popFrom(Shard& shard) {
+        T top = shard.heap.extractMin();
+        shard.size.store(shard.heap.heapSize(), memory_order_relaxed);
+        return top;
+    }
+
+    // Private helper function to pop from any non-empty shard, waiting for the locks;
+    // used when random picks keep finding empty shards
+    bool popAny(T& out) {
+        for (int k = 0; k < shardCount; k++) {
+            if (shards[k].size.load(memory_order_relaxed) == 0) {
+                continue;
+            }
+            lock_guard<mutex> guard(shards[k].lock);
+            if (!shards[k].heap.isEmpty()) {
+                out = popFrom(shards[k]);
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    // Constructor for the MultiQueue class: c shards per thread
+    MultiQueue(int threads, int c = 2) {
+        shardCount = max(2, threads * c);
+        shards = new Shard[shardCount];
+        id = nextId();
+    }
+
+    // Destructor to deallocate memory
+    ~MultiQueue() {
+        delete[] shards;
+    }
+
+    MultiQueue(const MultiQueue&) = delete;
+    MultiQueue& operator=(const MultiQueue&) = delete;
+
+    // Public function to add an element to a random shard
+    void add(T element) {
+        Sticky& state = sticky();
+        while (true) {
+            if (state.addLeft == 0) {
+                state.addShard = randomShard(state);
+                state.addLeft = STICKINESS;
+            }
+            Shard& shard = shards[state.addShard];
+            if (shard.lock.try_lock()) {
+                shard.heap.add(element);
+                shard.size.store(shard.heap.heapSize(), memory_order_relaxed);
+                shard.lock.unlock();
+                state.addLeft--;
+                return;
+            }
+            state.addLeft = 0;
+        }
+    }
+
+    /**
+     * Extracts a near-minimum element: the smaller top of two random shards.
+     *
+     * @param out Receives the extracted element.
+     * @return false if every shard was empty, true otherwise.
+     */
+    bool extractMin(T& out) {
+        Sticky& state = sticky();
+        int misses = 0;
+        while (true) {
+            if (state.popLeft == 0) {
+                state.popShards[0] = randomShard(state);
+                state.popShards[1] = randomShard(state);
+                if (state.popShards[0] == state.popShards[1]) {
+                    state.popShards[1] = (state.popShards[1] + 1) % shardCount;
+                }
+                state.popLeft = STICKINESS;
+            }
+            Shard& first = shards[state.popShards[0]];
+            Shard& second = shards[state.popShards[1]];
+
+            // Both picks empty: try another pair, and after enough misses check every shard
+            if (first.size.load(memory_order_relaxed) == 0 && second.size.load(memory_order_relaxed) == 0) {
+                state.popLeft = 0;
+                if (++misses >= shardCount) {
+                    return popAny(out);
+                }
+                continue;
+            }
+
+            if (!first.lock.try_lock()) {
+                state.popLeft = 0;
+                continue;
+            }
+            if (!second.lock.try_lock()) {
+                first.lock.unlock();
+                state.popLeft = 0;
+                continue;
+            }
+
+            // Pick the shard with the smaller top among the non-empty ones
+            Shard* best = nullptr;
+            if (!first.heap.isEmpty()) {
+                best = &first;
+            }
+            if (!second.heap.isEmpty() && (best == nullptr || best->heap.peek() > second.heap.peek())) {
+                best = &second;
+            }
+
+            bool found = (best != nullptr);
+            if (found) {
+                out = popFrom(*best);
+            }
+
+            second.lock.unlock();
+            first.lock.unlock();
+
+            if (found) {
+                state.popLeft--;
+                return true;
+            }
+            state.popLeft = 0;
+        }
+    }
+
+    // Public function to get the approximate number of elements
+    int approxSize() {
+        int total = 0;
+        for (int k = 0; k < shardCount; k++) {
+            total += shards[k].size.load(memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Public function to check if the queue is (approximately) empty
+    bool isEmpty() {
+        return approxSize() == 0;
+    }
+
+    // Public function to get the number of shards
+    int shardsCount() {
+        return shardCount;
+    }
+};
+
+/**
+ * Quality metric for a relaxed priority queue: for every pop, the rank error is the number of
+ * elements still in the queue that are strictly smaller than the popped one (0 for an exact pop).
+ * Fills the queue with the keys 0..n-1 in shuffled order, then drains it on a single thread.
+ *
+ * @param queue The (empty) queue to measure.
+ * @param n The number of keys to insert.
+ * @param maxError Receives the largest rank error seen.
+ * @return The mean rank error per pop.
+ */
+template <class Q>
+double RANK_ERROR(Q& queue, int n, int& maxError) {
+    int* keys = new int[n];
+    int* tree = new int[n + 1];     // Fenwick tree over keys still in the queue
+    for (int i = 0; i < n; i++) {
+        keys[i] = i;
+    }
+    for (int i = 1; i <= n; i++) {
+        tree[i] = 0;
+    }
+    unsigned int seed = 12345;
+    for (int i = n - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        swap(keys[i], keys[(seed >> 8) % (i + 1)]);
+    }
+    for (int i = 0; i < n; i++) {
+        queue.add(keys[i]);
+        for (int k = keys[i] + 1; k <= n; k += k & -k) {
+            tree[k]++;
+        }
+    }
+
+    long long total = 0;
+    maxError = 0;
+    int key;
+    while (queue.extractMin(key)) {
+        // Number of keys still present that are smaller than key
+        int smaller = 0;
+        for (int k = key; k > 0; k -= k & -k) {
+            smaller += tree[k];
+        }
+        total += smaller;
+        maxError = max(maxError, smaller);
+        for (int k = key + 1; k <= n; k += k & -k) {
+            tree[k]--;
+        }
+    }
+
+    delete[] keys;
+    delete[] tree;
+    return (double) total / n;
+}
+
+/**
+ * Contention benchmark: each thread runs ops operations alternating add and extractMin.
+ *
+ * @param queue The queue under test (MultiQueue or any type with add/extractMin(T&)).
+ * @param threads The number of worker threads.
+ * @param ops The number of operations per thread.
+ * @return The throughput in million operations per second.
+ */
+template <class Q>
+double CONTENTION_BENCHMARK(Q& queue, int threads, int ops) {
+    for (int i = 0; i < threads * 64; i++) {
+        queue.add(i);
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&queue, ops, t]() {
+            int value;
+            for (int i = 0; i < ops; i++) {
+                if (i & 1) {
+                    queue.extractMin(value);
+                } else {
+                    queue.add(t * ops + i);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    return threads * (double) ops / elapsed.count() / 1e6;
+}
+
+// Baseline for the benchmark: one MinHeap behind a global mutex
+template <class T>
+class LockedMinHeap {
+    mutex lock;         // Global lock guarding the heap
+    MinHeap<T> heap;    // The single shared heap
+
+public:
+    // Public function to add an element under the global lock
+    void add(T element) {
+        lock_guard<mutex> guard(lock);
+        heap.add(element);
+    }
+
+    // Public function to extract the exact minimum under the global lock
+    bool extractMin(T& out) {
+        lock_guard<mutex> guard(lock);
+        if (heap.isEmpty()) {
+            return false;
+        }
+        out = heap.extractMin();
+        return true;
+    }
+};
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+
+//----------------------------------------------------------------
+//-------------------Bounded Top-K accumulator--------------------
+//----------------------------------------------------------------
+/**
+ * Wrapper that flips the comparison operators of T, so the max-heap functions above
+ * can keep a min-heap (the root becomes the smallest kept element).
+ *
+ * @tparam T The wrapped type.
+ */
+template<typename T>
+struct Reversed {
+    T value;
+
+    bool operator<(const Reversed& other) const {
+        return other.value < value;
+    }
+
+    bool operator>(const Reversed& other) const {
+        return value < other.value;
+    }
+};
+
+/**
+ * Fixed-capacity accumulator keeping the k largest (Largest = true) or k smallest
+ * (Largest = false) elements of a stream, stored as a max-heap of at most k keys and
+ * maintained with BUILD_MAX_HEAP / MAX_HEAPIFY. The root is the current threshold:
+ * an element that does not beat it is rejected with a single comparison, otherwise it
+ * replaces the root in place.
+ *
+ * @tparam T The type of elements in the stream.
+ * @tparam Largest Keep the largest elements if true, the smallest if false.
+ */
+template<typename T, bool Largest = true>
+class TopK {
+    typedef typename conditional<Largest, Reversed<T>, T>::type Key;
+
+    Key* heap;      // Heap array (unordered until it holds k elements)
+    int k;          // Number of elements to keep
+    int size = 0;   // Current number of elements kept
+
+    // Private helper functions to move between T and the heap key type
+    static Key toKey(const T& value) {
+        return Key{value};
+    }
+
+    static T fromKey(const Key& key) {
+        if constexpr (Largest) {
+            return key.value;
+        } else {
+            return key;
+        }
+    }
+
+    // Private helper function to check if value would enter a full accumulator
+    bool beatsThreshold(const T& value) {
+        if constexpr (Largest) {
+            return heap[0].value < value;
+        } else {
+            return value < heap[0];
+        }
+    }
+
+#ifdef __AVX2__
+    // Private helper function to process 8 lanes at a time, keeping only lanes that beat the threshold
+    template<typename V>
+    int offerVector(const V* data, int n) {
+        int i = 0;
+        if constexpr (is_same<V, int>::value) {
+            __m256i threshold = _mm256_set1_epi32(fromKey(heap[0]));
+            for (; i + 8 <= n; i += 8) {
+                __m256i block = _mm256_loadu_si256((const __m256i*) (data + i));
+                __m256i hit = Largest ? _mm256_cmpgt_epi32(block, threshold) : _mm256_cmpgt_epi32(threshold, block);
+                unsigned int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+                if (mask != 0) {
+                    for (; mask != 0; mask &= mask - 1) {
+                        offer(data[i + __builtin_ctz(mask)]);
+                    }
+                    threshold = _mm256_set1_epi32(fromKey(heap[0]));
+                }
+            }
+        } else if constexpr (is_same<V, float>::value) {
+            __m256 threshold = _mm256_set1_ps(fromKey(heap[0]));
+            for (; i + 8 <= n; i += 8) {
+                __m256 block = _mm256_loadu_ps(data + i);
+                __m256 hit = _mm256_cmp_ps(block, threshold, Largest ? _CMP_GT_OQ : _CMP_LT_OQ);
+                unsigned int mask = _mm256_movemask_ps(hit);
+                if (mask != 0) {
+                    for (; mask != 0; mask &= mask - 1) {
+                        offer(data[i + __builtin_ctz(mask)]);
+                    }
+                    threshold = _mm256_set1_ps(fromKey(heap[0]));
+                }
+            }
+        }
+        return i;
+    }
+#endif
+
+public:
+    // Constructor for the TopK class
+    TopK(int _k) {
+        k = max(1, _k);
+        heap = new Key[k];
+    }
+
+    // Destructor to deallocate memory
+    ~TopK() {
+        delete[] heap;
+    }
+
+    TopK(const TopK&) = delete;
+    TopK& operator=(const TopK&) = delete;
+
+    /**
+     * Offers one element to the accumulator.
+     *
+     * @param value The element from the stream.
+     * @return true if the element is kept (for now), false if it was rejected.
+     */
+    bool offer(const T& value) {
+        if (size < k) {
+            heap[size++] = toKey(value);
+            if (size == k) {
+                BUILD_MAX_HEAP(heap, k);
+            }
+            return true;
+        }
+
+        if (!beatsThreshold(value)) {
+            return false;
+        }
+
+        // Replace the root in place and sift it down
+        heap[0] = toKey(value);
+        MAX_HEAPIFY(heap, 0, k);
+        return true;
+    }
+
+    /**
+     * Offers a batch of elements. Once the accumulator is full, int and float batches are
+     * pre-filtered 8 at a time with AVX2 against the current threshold (when compiled with AVX2).
+     *
+     * @param data The batch.
+     * @param n The number of elements in the batch.
+     */
+    void offerBatch(const T* data, int n) {
+        int i = 0;
+        while (i < n && size < k) {
+            offer(data[i++]);
+        }
+
+#ifdef __AVX2__
+        i += offerVector(data + i, n - i);
+#endif
+
+        for (; i < n; i++) {
+            if (beatsThreshold(data[i])) {
+                heap[0] = toKey(data[i]);
+                MAX_HEAPIFY(heap, 0, k);
+            }
+        }
+    }
+
+    /**
+     * Merges another accumulator (e.g. from another thread) into this one.
+     *
+     * @param other The accumulator to merge; it is left unchanged.
+     */
+    void merge(const TopK& other) {
+        for (int i = 0; i < other.size; i++) {
+            offer(fromKey(other.heap[i]));
+        }
+    }
+
+    // Public function to get the current threshold (the worst element kept); only valid once full
+    T threshold() {
+        if (size < k) {
+            throw OutOfRange();
+        }
+        return fromKey(heap[0]);
+    }
+
+    // Public function to get the number of elements kept
+    int count() {
+        return size;
+    }
+
+    // Public function to check if the accumulator holds k elements
+    bool isFull() {
+        return size == k;
+    }
+
+    /**
+     * Returns the kept elements, best first (descending for top-k, ascending for bottom-k).
+     */
+    vector<T> result() {
+        Key* sorted = new Key[size];
+        for (int i = 0; i < size; i++) {
+            sorted[i] = heap[i];
+        }
+        HEAP_SORT(sorted, size);
+
+        vector<T> out;
+        for (int i = 0; i < size; i++) {
+            out.push_back(fromKey(sorted[i]));
+        }
+        delete[] sorted;
+        return out;
+    }
+
+    // Public function to reset the accumulator
+    void clear() {
+        size = 0;
+    }
+};
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+
+//----------------------------------------------------------------
+//-------------------Hierarchical Timer Wheel---------------------
+//----------------------------------------------------------------
+/**
+ * Hierarchical timing wheel: 4 levels of 256 slots cover 2^32 ticks. Timers live in
+ * intrusive doubly linked slot lists, so schedule and cancel are O(1); a level-0 slot is
+ * expired as one batch per tick and higher levels cascade down when the level below wraps.
+ * Timers further away than the wheel horizon wait in a MinHeap ordered by expiry and are
+ * moved into the wheel once they come within range.
+ *
+ * @tparam T The payload handed to the expiry callback.
+ */
+template <class T>
+class TimerWheel {
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const unsigned long long HORIZON = 1ULL << (LEVELS * SLOT_BITS);
+
+    // States of a timer node
+    enum State { FREE, IN_WHEEL, IN_OVERFLOW, CANCELLED, FIRING };
+
+    // Timer node stored in the pool
+    struct Node {
+        unsigned long long expiry;  // Absolute tick the timer fires at
+        T payload;                  // Value handed to the callback
+        int prev, next;             // Neighbours in the slot list (-1 = none); while FIRING,
+                                    // next chains the batch being expired
+        int slot;                   // Index of the slot list head (level * SLOTS + slot)
+        unsigned int generation;    // Bumped on every reuse so stale handles are rejected
+        State state;
+    };
+
+    // Entry of the overflow MinHeap
+    struct Overflow {
+        unsigned long long expiry;
+        int node;
+
+        bool operator>(const Overflow& other) const {
+            return expiry > other.expiry;
+        }
+
+        bool operator==(const Overflow& other) const {
+            return expiry == other.expiry && node == other.node;
+        }
+    };
+
+    vector<Node> nodes;                 // Pool of timer nodes
+    int freeList = -1;                  // Free nodes linked through next
+    int heads[LEVELS * SLOTS];          // Heads of the slot lists
+    MinHeap<Overflow> overflow;         // Timers beyond the wheel horizon
+    unsigned long long now = 0;         // Current tick
+    int active = 0;                     // Number of scheduled (not fired, not cancelled) timers
+    int inWheel = 0;                    // Number of timers currently linked into slot lists
+
+    // Private helper function to take a node from the pool
+    int allocate() {
+        if (freeList == -1) {
+            nodes.push_back(Node());
+            nodes.back().generation = 0;
+            return (int) nodes.size() - 1;
+        }
+        int index = freeList;
+        freeList = nodes[index].next;
+        return index;
+    }
+
+    // Private helper function to return a node to the pool
+    void release(int index) {
+        nodes[index].state = FREE;
+        nodes[index].generation++;
+        nodes[index].next = freeList;
+        freeList = index;
+    }
+
+    // Private helper function to put a node in the wheel level matching its distance from now
+    void place(int index) {
+        Node& node = nodes[index];
+        unsigned long long distance = node.expiry - now;
+        if (distance >= HORIZON) {
+            node.state = IN_OVERFLOW;
+            overflow.add(Overflow{node.expiry, index});
+            return;
+        }
+
+        int level = 0;
+        while (distance >= (1ULL << ((level + 1) * SLOT_BITS))) {
+            level++;
+        }
+        int slot = level * SLOTS + (int) ((node.expiry >> (level * SLOT_BITS)) & (SLOTS - 1));
+
+        node.state = IN_WHEEL;
+        node.slot = slot;
+        inWheel++;
+        node.prev = -1;
+        node.next = heads[slot];
+        if (heads[slot] != -1) {
+            nodes[heads[slot]].prev = index;
+        }
+        heads[slot] = index;
+    }
+
+    // Private helper function to unlink a node from its slot list
+    void unlink(int index) {
+        Node& node = nodes[index];
+        if (node.prev != -1) {
+            nodes[node.prev].next = node.next;
+        } else {
+            heads[node.slot] = node.next;
+        }
+        if (node.next != -1) {
+            nodes[node.next].prev = node.prev;
+        }
+        inWheel--;
+    }
+
+    // Private helper function to move every timer of a higher-level slot one level down
+    void cascade(int slot) {
+        int index = heads[slot];
+        heads[slot] = -1;
+        while (index != -1) {
+            int next = nodes[index].next;
+            inWheel--;
+            place(index);
+            index = next;
+        }
+    }
+
+public:
+    // Constructor for the TimerWheel class
+    TimerWheel() {
+        for (int i = 0; i < LEVELS * SLOTS; i++) {
+            heads[i] = -1;
+        }
+    }
+
+    /**
+     * Schedules a timer to fire delay ticks from now (at least one tick).
+     *
+     * @param delay The number of ticks until expiry.
+     * @param payload The value handed to the callback on expiry.
+     * @return A handle that can be passed to cancel().
+     */
+    long long schedule(unsigned long long delay, T payload) {
+        int index = allocate();
+        Node& node = nodes[index];
+        node.expiry = now + (delay == 0 ? 1 : delay);
+        node.payload = payload;
+        place(index);
+        active++;
+        return (long long) (((unsigned long long) node.generation << 32) | (unsigned int) index);
+    }
+
+    /**
+     * Cancels a pending timer in O(1); timers in the overflow heap are dropped lazily.
+     * A timer whose tick is being expired can no longer be cancelled, even from the
+     * callback of another timer of the same tick.
+     *
+     * @param handle The handle returned by schedule().
+     * @return true if the timer was pending, false if it fired, is firing or was cancelled.
+     */
+    bool cancel(long long handle) {
+        int index = (int) (handle & 0xFFFFFFFFLL);
+        unsigned int generation = (unsigned int) ((unsigned long long) handle >> 32);
+        if (index < 0 || index >= (int) nodes.size() || nodes[index].generation != generation) {
+            return false;
+        }
+
+        Node& node = nodes[index];
+        if (node.state == IN_WHEEL) {
+            unlink(index);
+            release(index);
+        } else if (node.state == IN_OVERFLOW) {
+            node.state = CANCELLED;
+        } else {
+            return false;
+        }
+        active--;
+        return true;
+    }
+
+    /**
+     * Advances the wheel by a number of ticks, calling onExpire(payload) for every timer
+     * that fires; all timers of a tick are expired together. Stretches in which the wheel
+     * is empty are skipped in one step.
+     *
+     * @param ticks The number of ticks to advance.
+     * @param onExpire Callback invoked with each expired payload.
+     * @return The number of timers that fired.
+     */
+    template <class F>
+    int advance(unsigned long long ticks, F onExpire) {
+        int fired = 0;
+        unsigned long long target = now + ticks;
+        while (now < target) {
+            // Nothing can fire before the next overflow timer while the wheel is empty
+            if (inWheel == 0) {
+                unsigned long long next = overflow.isEmpty() ? target : min(target, overflow.peek().expiry);
+                now = next - 1;
+            }
+            now++;
+
+            // Cascade the higher levels whose lower level just wrapped around
+            for (int level = 1; level < LEVELS; level++) {
+                if ((now & ((1ULL << (level * SLOT_BITS)) - 1)) != 0) {
+                    break;
+                }
+                cascade(level * SLOTS + (int) ((now >> (level * SLOT_BITS)) & (SLOTS - 1)));
+            }
+
+            // Pull overflow timers that are now within the horizon
+            while (!overflow.isEmpty() && overflow.peek().expiry - now < HORIZON) {
+                int index = overflow.extractMin().node;
+                if (nodes[index].state == CANCELLED) {
+                    release(index);
+                } else {
+                    place(index);
+                }
+            }
+
+            // Expire the whole level-0 slot as one batch. The slot is detached before any
+            // callback runs, so callbacks may cancel or schedule timers freely: the batch
+            // is only reachable through the next links of its FIRING nodes.
+            int slot = (int) (now & (SLOTS - 1));
+            int batch = heads[slot];
+            heads[slot] = -1;
+            for (int index = batch; index != -1; index = nodes[index].next) {
+                nodes[index].state = FIRING;
+                nodes[index].prev = -1;
+                inWheel--;
+            }
+            int index = batch;
+            while (index != -1) {
+                int next = nodes[index].next;
+                T payload = nodes[index].payload;
+                release(index);
+                active--;
+                fired++;
+                onExpire(payload);
+                index = next;
+            }
+        }
+        return fired;
+    }
+
+    // Public function to get the current tick
+    unsigned long long currentTick() {
+        return now;
+    }
+
+    // Public function to get the number of pending timers
+    int pending() {
+        return active;
+    }
+
+    // Public function to check if there are no pending timers
+    bool isEmpty() {
+        return active == 0;
+    }
+};
+
+/**
+ * Timeout benchmark: connections is the number of concurrently open requests. Every tick,
+ * ops requests complete (their timeout is cancelled) and are replaced by a new request with
+ * a fresh timeout of about timeout ticks, so nearly every timer is cancelled before it fires.
+ * Runs the TimerWheel against a MinHeap timer queue that cancels lazily with tombstones.
+ *
+ * @return The speed-up of the wheel over the MinHeap queue.
+ */
+double TIMEOUT_BENCHMARK(int connections, int ticks, int ops, int timeout) {
+    unsigned int seed = 2024;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 8;
+    };
+
+    // Timer wheel
+    TimerWheel<int> wheel;
+    vector<long long> handles(connections);
+    int wheelFired = 0;
+    auto start = chrono::steady_clock::now();
+    for (int c = 0; c < connections; c++) {
+        handles[c] = wheel.schedule(timeout + nextRandom() % timeout, c);
+    }
+    for (int t = 0; t < ticks; t++) {
+        for (int i = 0; i < ops; i++) {
+            int c = nextRandom() % connections;
+            wheel.cancel(handles[c]);
+            handles[c] = wheel.schedule(timeout + nextRandom() % timeout, c);
+        }
+        wheelFired += wheel.advance(1, [](int) {});
+    }
+    chrono::duration<double> wheelTime = chrono::steady_clock::now() - start;
+
+    // MinHeap keyed by (expiry, generation), cancelled entries skipped when they reach the top
+    MinHeap<pair<unsigned long long, long long>> heap;
+    vector<long long> current(connections);
+    int heapFired = 0;
+    long long generation = 0;
+    unsigned long long now = 0;
+    seed = 2024;
+    start = chrono::steady_clock::now();
+    for (int c = 0; c < connections; c++) {
+        current[c] = ++generation * connections + c;
+        heap.add({now + timeout + nextRandom() % timeout, current[c]});
+    }
+    for (int t = 0; t < ticks; t++) {
+        for (int i = 0; i < ops; i++) {
+            int c = nextRandom() % connections;
+            current[c] = ++generation * connections + c;
+            heap.add({now + timeout + nextRandom() % timeout, current[c]});
+        }
+        now++;
+        while (!heap.isEmpty() && heap.peek().first <= now) {
+            long long id = heap.extractMin().second;
+            if (current[id % connections] == id) {
+                current[id % connections] = -1;
+                heapFired++;
+            }
+        }
+    }
+    chrono::duration<double> heapTime = chrono::steady_clock::now() - start;
+
+    std::cout << "TimerWheel " << wheelTime.count() << "s (" << wheelFired << " fired), MinHeap "
+              << heapTime.count() << "s (" << heapFired << " fired)" << std::endl;
+    return heapTime.count() / wheelTime.count();
+}
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+
 
 
 
@@ -396,6 +1286,185 @@ int main() {
     HEAP_CHANGE_KEY(array3, 2, 10);
     std::cout << "HEAP_CHANGE_KEY result: ";
     printArray(array3, size3);
+//----------------------------------------------------------------
+//              Test Cases For MultiQueue
+//----------------------------------------------------------------
+    MultiQueue<int> multiQueue(4);
+    assert(multiQueue.shardsCount() == 8);
+    assert(multiQueue.isEmpty());
+    int popped;
+    assert(!multiQueue.extractMin(popped));
+
+    // Every element comes out exactly once
+    for (int i = 0; i < 100; i++) {
+        multiQueue.add(i);
+    }
+    long long poppedSum = 0;
+    int poppedCount = 0;
+    while (multiQueue.extractMin(popped)) {
+        poppedSum += popped;
+        poppedCount++;
+    }
+    assert(poppedCount == 100 && poppedSum == 4950);
+
+    // Relaxed ordering stays close to the true minimum
+    int maxRankError;
+    MultiQueue<int> qualityQueue(4);
+    double meanRankError = RANK_ERROR(qualityQueue, 20000, maxRankError);
+    std::cout << "\nMultiQueue rank error: mean " << meanRankError << ", max " << maxRankError << std::endl;
+    assert(meanRankError < 64);
+
+    // Contention benchmark against a single mutex-guarded MinHeap; the sharding only pays off
+    // when the threads really run in parallel, so the number of hardware threads is printed too
+    std::cout << "Hardware threads: " << thread::hardware_concurrency() << std::endl;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        MultiQueue<int> shardedQueue(threads);
+        LockedMinHeap<int> lockedHeap;
+        double sharded = CONTENTION_BENCHMARK(shardedQueue, threads, 100000);
+        double locked = CONTENTION_BENCHMARK(lockedHeap, threads, 100000);
+        std::cout << threads << " threads: MultiQueue " << sharded << " Mops/s, locked MinHeap " << locked << " Mops/s" << std::endl;
+    }
+//----------------------------------------------------------------
+//              Test Cases For TopK
+//----------------------------------------------------------------
+    TopK<int> top3(3);
+    int stream[] = { 4, 9, 1, 7, 3, 8, 2 };
+    for (int value : stream) {
+        top3.offer(value);
+    }
+    assert(top3.threshold() == 7);
+    assert(!top3.offer(5));
+    vector<int> best = top3.result();
+    assert(best.size() == 3 && best[0] == 9 && best[1] == 8 && best[2] == 7);
+
+    TopK<int, false> bottom3(3);
+    bottom3.offerBatch(stream, 7);
+    vector<int> worst = bottom3.result();
+    assert(worst.size() == 3 && worst[0] == 1 && worst[1] == 2 && worst[2] == 3);
+
+    // Batches (SIMD pre-filtered when built with AVX2) match a full sort
+    int streamSize = 100000;
+    vector<int> ints(streamSize);
+    vector<float> floats(streamSize);
+    unsigned int topSeed = 99;
+    for (int i = 0; i < streamSize; i++) {
+        topSeed = topSeed * 1103515245u + 12345u;
+        ints[i] = (int) (topSeed >> 1) - (1 << 30);
+        floats[i] = (float) (topSeed >> 8) / 1024.0f;
+    }
+    TopK<int> topInts(100);
+    topInts.offerBatch(ints.data(), streamSize);
+    TopK<float, false> bottomFloats(100);
+    bottomFloats.offerBatch(floats.data(), streamSize);
+    vector<int> sortedInts = ints;
+    vector<float> sortedFloats = floats;
+    sort(sortedInts.rbegin(), sortedInts.rend());
+    sort(sortedFloats.begin(), sortedFloats.end());
+    vector<int> topIntsResult = topInts.result();
+    vector<float> bottomFloatsResult = bottomFloats.result();
+    for (int i = 0; i < 100; i++) {
+        assert(topIntsResult[i] == sortedInts[i]);
+        assert(bottomFloatsResult[i] == sortedFloats[i]);
+    }
+
+    // Per-thread accumulators merged at the end
+    TopK<int> partials[4] = { TopK<int>(100), TopK<int>(100), TopK<int>(100), TopK<int>(100) };
+    vector<thread> accumulators;
+    for (int t = 0; t < 4; t++) {
+        accumulators.emplace_back([&partials, &ints, streamSize, t]() {
+            int chunk = streamSize / 4;
+            partials[t].offerBatch(ints.data() + t * chunk, chunk);
+        });
+    }
+    for (auto& accumulator : accumulators) {
+        accumulator.join();
+    }
+    TopK<int> merged(100);
+    for (int t = 0; t < 4; t++) {
+        merged.merge(partials[t]);
+    }
+    assert(merged.result() == topIntsResult);
+    std::cout << "All TopK test cases passed!" << std::endl;
+//----------------------------------------------------------------
+//              Test Cases For TimerWheel
+//----------------------------------------------------------------
+    TimerWheel<int> wheel;
+    vector<int> expired;
+    auto collect = [&expired](int payload) { expired.push_back(payload); };
+    wheel.schedule(5, 1);
+    long long cancelled = wheel.schedule(5, 2);
+    wheel.schedule(300, 3);                 // Level 1
+    wheel.schedule(70000, 4);               // Level 2
+    wheel.schedule(1ULL << 40, 5);          // Beyond the horizon: overflow MinHeap
+    long long cancelledFar = wheel.schedule((1ULL << 40) + 1, 6);
+    assert(wheel.pending() == 6);
+    assert(wheel.cancel(cancelled));
+    assert(!wheel.cancel(cancelled));
+    assert(wheel.cancel(cancelledFar));
+
+    assert(wheel.advance(4, collect) == 0);
+    assert(wheel.advance(1, collect) == 1 && expired.back() == 1);
+    assert(wheel.advance(294, collect) == 0);
+    assert(wheel.advance(1, collect) == 1 && expired.back() == 3);
+    assert(wheel.currentTick() == 300);
+    assert(wheel.advance(69699, collect) == 0);
+    assert(wheel.advance(1, collect) == 1 && expired.back() == 4);
+    assert(wheel.advance((1ULL << 40) - 70001, collect) == 0);
+    assert(wheel.advance(1, collect) == 1 && expired.back() == 5);
+    assert(wheel.isEmpty());
+    assert(wheel.currentTick() == (1ULL << 40));
+
+    // Random delays fire exactly on their tick
+    TimerWheel<unsigned long long> randomWheel;
+    unsigned int wheelSeed = 5;
+    for (int i = 0; i < 20000; i++) {
+        wheelSeed = wheelSeed * 1103515245u + 12345u;
+        unsigned long long delay = 1 + (wheelSeed >> 8) % 200000;
+        randomWheel.schedule(delay, delay);
+    }
+    int wheelFired = randomWheel.advance(200000, [&randomWheel](unsigned long long expiry) {
+        assert(randomWheel.currentTick() == expiry);
+    });
+    assert(wheelFired == 20000);
+
+    // Callbacks cancelling and scheduling timers while their tick is expired
+    TimerWheel<int> timeoutWheel;
+    long long handles[4];
+    handles[0] = timeoutWheel.schedule(3, 0);
+    handles[1] = timeoutWheel.schedule(3, 1);
+    handles[2] = timeoutWheel.schedule(3, 2);
+    handles[3] = timeoutWheel.schedule(4, 3);
+    vector<int> order;
+    int cancelsAccepted = 0;
+    auto onTimeout = [&](int payload) {
+        order.push_back(payload);
+        if (order.size() == 1) {
+            // Siblings of the same tick are already firing; the next tick's timer is not
+            for (int i = 0; i < 3; i++) {
+                cancelsAccepted += timeoutWheel.cancel(handles[i]);
+            }
+            cancelsAccepted += timeoutWheel.cancel(handles[3]);
+            timeoutWheel.schedule(2, 10 + payload);
+        }
+    };
+    assert(timeoutWheel.advance(3, onTimeout) == 3);
+    assert(cancelsAccepted == 1);
+    assert(order.size() == 3 && timeoutWheel.pending() == 1);
+    assert(timeoutWheel.advance(2, onTimeout) == 1 && order.back() == 10 + order[0]);
+    assert(timeoutWheel.isEmpty());
+    for (int i = 0; i < 3; i++) {
+        assert(!timeoutWheel.cancel(handles[i]));
+    }
+    for (int i = 0; i < 1000; i++) {
+        timeoutWheel.schedule(1 + i % 7, i);    // Reuses the released nodes
+    }
+    assert(timeoutWheel.advance(7, [](int) {}) == 1000);
+    assert(timeoutWheel.isEmpty());
+
+    // Cancel-heavy timeout workload against a MinHeap timer queue
+    double speedUp = TIMEOUT_BENCHMARK(100000, 5000, 200, 1000);
+    std::cout << "TimerWheel speed-up over MinHeap: " << speedUp << "x" << std::endl;
+    std::cout << "All TimerWheel test cases passed!" << std::endl;
     return 0;
 }
 
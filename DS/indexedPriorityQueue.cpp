@@ -10,15 +10,129 @@
 
 
 #include <iostream>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <type_traits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <stdexcept>
 #include <cassert>
+#include "denseKeyMap.h"
 
 using namespace std;
 
+// Batch operations shared by indexedPriorityQueue and leanIndexedPriorityQueue. Both queues
+// keep _size, capacity, growable and a posMap from key index to heap position, sift with
+// swim(position) and heapify(), and expose three small hooks: append(key, value) puts an entry
+// at position _size without sifting it, dropLast() takes that entry back off, and valueRef(key)
+// is the value stored for a key index in the queue.
+struct heapBatch {
+    // Function to decide if a batch of k sifts in a heap of n entries costs more than a rebuild
+    static bool preferRebuild(int k, int n) {
+        int depth = 1;
+        while ((1LL << depth) < n) {
+            depth++;
+        }
+        return (long long) k * depth > n;
+    }
+
+    // Function to insert a batch of key indices into queue q: every key is checked and the
+    // arrays grown once before anything is appended, so a bad key leaves q as it was
+    template <typename Q, typename T>
+    static void insertAll(Q& q, const vector<int>& keys, const vector<T>& values) {
+        if (keys.size() != values.size()) {
+            throw invalid_argument("Keys and values differ in size");
+        }
+        int highest = -1;
+        for (int keyIndex : keys) {
+            if (keyIndex < 0 || (keyIndex >= q.capacity && !q.growable)) {
+                throw out_of_range("Key index out of range");
+            }
+            if (q.contains(keyIndex)) {
+                throw invalid_argument("Key already exists");
+            }
+            highest = max(highest, keyIndex);
+        }
+        if (highest >= q.capacity) {
+            q.grow(highest);
+        }
+
+        int k = (int) keys.size();
+        bool rebuild = preferRebuild(k, q._size + k);
+        for (int j = 0; j < k; j++) {
+            if (q.contains(keys[j])) {
+                // Duplicate inside the batch: undo the part already appended
+                for (int r = j - 1; r >= 0; r--) {
+                    if (rebuild) {
+                        q.dropLast();   // Still an unsifted tail: just cut it off
+                    } else {
+                        q.remove(keys[r]);
+                    }
+                }
+                throw invalid_argument("Key already exists");
+            }
+            q.append(keys[j], values[j]);
+            if (!rebuild) {
+                q.swim(q._size - 1);
+            }
+        }
+
+        if (rebuild) {
+            q.heapify();
+        }
+    }
+
+    // Function to decrease a batch of values in queue q (values that are not smaller are
+    // ignored); returns the number of values lowered
+    template <typename Q, typename T>
+    static int decreaseBatch(Q& q, const vector<int>& keys, const vector<T>& values) {
+        if (keys.size() != values.size()) {
+            throw invalid_argument("Keys and values differ in size");
+        }
+        for (int keyIndex : keys) {
+            if (!q.contains(keyIndex)) {
+                throw out_of_range("Key not found");
+            }
+        }
+
+        int k = (int) keys.size();
+        bool rebuild = preferRebuild(k, q._size);
+        int lowered = 0;
+        for (int j = 0; j < k; j++) {
+            T& value = q.valueRef(keys[j]);
+            if (values[j] < value) {
+                value = values[j];
+                lowered++;
+                if (!rebuild) {
+                    q.swim(q.posMap[keys[j]]);
+                }
+            }
+        }
+
+        if (rebuild && lowered > 0) {
+            q.heapify();
+        }
+        return lowered;
+    }
+};
+
 template <typename T>
 class indexedPriorityQueue {
     int _size = 0;          // Current size of the indexed priority queue
     int capacity;           // Capacity of the indexed priority queue
     int degree = 2;         // Degree of each node in the heap
+    bool growable;          // Whether the arrays grow when a key index reaches the capacity
     int* child;             // Array storing the indices of child nodes
     int* parent;            // Array storing the indices of parent nodes
     int* posMap;            // Mapping from key index to position in the heap
@@ -45,7 +159,8 @@ class indexedPriorityQueue {
     // Function to find the minimum child index of the element at index i in the heap
     int minChild(int i) {
         int index = -1;
-        for (int j = child[i]; j < min(_size, child[i] + degree); j++) {
+        int last = min(_size, child[i] + degree);
+        for (int j = child[i]; j < last; j++) {
             if (values[inVMap[j]] < values[inVMap[i]]) {
                 index = i = j;
             }
@@ -54,6 +169,35 @@ class indexedPriorityQueue {
         return index;
     }
 
+    // Function to restore the heap bottom-up in O(n)
+    void heapify() {
+        for (int i = (_size - 2) / degree; i >= 0; i--) {
+            sink(i);
+        }
+    }
+
+    // Function to put key index keyIndex at the end of the heap without sifting it
+    void append(int keyIndex, T value) {
+        posMap[keyIndex] = _size;
+        inVMap[_size] = keyIndex;
+        values[keyIndex] = value;
+        _size++;
+    }
+
+    // Function to take the last entry off the heap
+    void dropLast() {
+        _size--;
+        posMap[inVMap[_size]] = -1;
+        inVMap[_size] = -1;
+    }
+
+    // Function to get the value stored for a key index in the queue
+    T& valueRef(int keyIndex) {
+        return values[keyIndex];
+    }
+
+    friend struct heapBatch;
+
     // Function to swap the elements at indices i and j in the heap
     void _swap(int i, int j) {
         posMap[inVMap[i]] = j;
@@ -61,10 +205,55 @@ class indexedPriorityQueue {
         swap(inVMap[i], inVMap[j]);
     }
 
+    // Function to grow the arrays geometrically until key index i fits, keeping the position maps
+    void grow(int i) {
+        if (i == numeric_limits<int>::max()) {
+            throw length_error("Key index too large");
+        }
+        int newCapacity = capacity;
+        while (newCapacity <= i) {
+            // Past half the int range doubling would overflow: take exactly what is needed
+            newCapacity = (newCapacity > numeric_limits<int>::max() / 2) ? i + 1 : 2 * newCapacity;
+        }
+
+        int* newChild = new int[newCapacity];
+        int* newParent = new int[newCapacity];
+        int* newPosMap = new int[newCapacity];
+        int* newInVMap = new int[newCapacity];
+        T* newValues = new T[newCapacity];
+
+        for (int j = 0; j < newCapacity; j++) {
+            newParent[j] = (j - 1) / degree;
+            newChild[j] = j * degree + 1;
+            if (j < capacity) {
+                newPosMap[j] = posMap[j];
+                newInVMap[j] = inVMap[j];
+                newValues[j] = values[j];
+            } else {
+                newPosMap[j] = newInVMap[j] = -1;
+            }
+        }
+
+        delete[] child;
+        delete[] parent;
+        delete[] posMap;
+        delete[] inVMap;
+        delete[] values;
+
+        child = newChild;
+        parent = newParent;
+        posMap = newPosMap;
+        inVMap = newInVMap;
+        values = newValues;
+        capacity = newCapacity;
+    }
+
 public:
-    // Constructor to initialize the indexed priority queue with a given capacity
-    indexedPriorityQueue(int _capacity) {
+    // Constructor to initialize the indexed priority queue with a given capacity;
+    // a growable queue accepts any non-negative key index and grows its arrays as needed
+    indexedPriorityQueue(int _capacity, bool _growable = false) {
         capacity = _capacity;
+        growable = _growable;
         if (capacity < 3) {
             capacity = 3;
         }
@@ -91,11 +280,23 @@ public:
         delete[] values;
     }
 
+    indexedPriorityQueue(const indexedPriorityQueue&) = delete;
+    indexedPriorityQueue& operator=(const indexedPriorityQueue&) = delete;
+
     // Function to get the current size of the indexed priority queue
     int size() {
         return _size;
     }
 
+    // Function to remove every key index in O(size), keeping the arrays
+    void clear() {
+        for (int i = 0; i < _size; i++) {
+            posMap[inVMap[i]] = -1;
+            inVMap[i] = -1;
+        }
+        _size = 0;
+    }
+
     // Function to check if the indexed priority queue is empty
     int isEmpty() {
         return _size == 0;
@@ -103,7 +304,7 @@ public:
 
     // Function to check if the indexed priority queue contains a key index
     bool contains(int keyIndex) {
-        return posMap[keyIndex] != -1;
+        return keyIndex >= 0 && keyIndex < capacity && posMap[keyIndex] != -1;
     }
 
     // Function to get the key index with the minimum value
@@ -119,7 +320,7 @@ public:
     }
 
     // Function to get the minimum value
-    int peekMinvalue() {
+    T peekMinvalue() {
         return values[inVMap[0]];
     }
 
@@ -132,6 +333,13 @@ public:
 
     // Function to insert a key index with a value into the indexed priority queue
     void insert(int keyIndex, T value) {
+        if (keyIndex < 0 || (keyIndex >= capacity && !growable)) {
+            throw out_of_range("Key index out of range");
+        }
+        if (keyIndex >= capacity) {
+            grow(keyIndex);
+        }
+
         if (!contains(keyIndex)) {
             posMap[keyIndex] = _size;
             inVMap[_size] = keyIndex;
@@ -156,7 +364,7 @@ public:
             swim(i);
             T value = values[keyIndex];
             posMap[keyIndex] = -1;
-            inVMap[keyIndex] = -1;
+            inVMap[_size] = -1;
 
             return value;
         }
@@ -194,8 +402,1050 @@ public:
             sink(posMap[keyIndex]);
         }
     }
+
+    /**
+     * Inserts a batch of key indices. When the batch is large compared to the queue the
+     * entries are appended and the heap is rebuilt bottom-up in O(n), otherwise each entry swims.
+     *
+     * @param keys The key indices to insert (none may be present already).
+     * @param vals The values of the key indices.
+     */
+    void insertAll(const vector<int>& keys, const vector<T>& vals) {
+        heapBatch::insertAll(*this, keys, vals);
+    }
+
+    /**
+     * Decreases the values of a batch of key indices (values that are not smaller are ignored).
+     * Small batches swim each lowered entry; large batches update every value and rebuild the heap in O(n).
+     *
+     * @param keys The key indices to decrease (all must be present).
+     * @param vals The new values.
+     * @return The number of values that were lowered.
+     */
+    int decreaseBatch(const vector<int>& keys, const vector<T>& vals) {
+        return heapBatch::decreaseBatch(*this, keys, vals);
+    }
+};
+
+// Lean indexed priority queue: the arity D is a compile-time constant so parent and child
+// positions are computed, and the heap array holds (value, key) pairs so comparisons during
+// swim and sink read the values in place. Two arrays instead of five.
+template <typename T, int D = 2>
+class leanIndexedPriorityQueue {
+    static_assert(D >= 2, "Heap degree must be at least 2");
+
+    // Heap entry: the value together with the key index it belongs to
+    struct Entry {
+        T value;
+        int key;
+    };
+
+    int _size = 0;          // Current size of the indexed priority queue
+    int capacity;           // Capacity of the indexed priority queue
+    bool growable;          // Whether the arrays grow when a key index reaches the capacity
+    Entry* heap;            // Heap of (value, key index) entries
+    int* posMap;            // Mapping from key index to position in the heap
+
+    // Function to move the entry at position i up until its parent is not larger
+    void swim(int i) {
+        Entry entry = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (!(entry.value < heap[parent].value)) {
+                break;
+            }
+            heap[i] = heap[parent];
+            posMap[heap[i].key] = i;
+            i = parent;
+        }
+        heap[i] = entry;
+        posMap[entry.key] = i;
+    }
+
+    // Function to move the entry at position i down until no child is smaller
+    void sink(int i) {
+        Entry entry = heap[i];
+        while (true) {
+            int j = minChild(i);
+            if (j == -1 || !(heap[j].value < entry.value)) {
+                break;
+            }
+            heap[i] = heap[j];
+            posMap[heap[i].key] = i;
+            i = j;
+        }
+        heap[i] = entry;
+        posMap[entry.key] = i;
+    }
+
+#ifdef __AVX2__
+    // Function to find the offset (0..7) of the smallest value among 8 consecutive int or float
+    // entries: the values are gathered out of the (value, key) pairs with one shuffle and one
+    // permute, reduced to the minimum, and located with a compare and a movemask
+    static int minOf8(const Entry* entries) {
+        if constexpr (is_same<T, float>::value) {
+            __m256 a = _mm256_loadu_ps((const float*) entries);
+            __m256 b = _mm256_loadu_ps((const float*) (entries + 4));
+            __m256 v = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            v = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3, 1, 2, 0)));
+            __m256 m = _mm256_min_ps(v, _mm256_permute2f128_ps(v, v, 1));
+            m = _mm256_min_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+            m = _mm256_min_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+            return __builtin_ctz(_mm256_movemask_ps(_mm256_cmp_ps(v, m, _CMP_EQ_OQ)));
+        } else {
+            __m256 a = _mm256_loadu_ps((const float*) entries);
+            __m256 b = _mm256_loadu_ps((const float*) (entries + 4));
+            __m256i v = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            v = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0));
+            __m256i m = _mm256_min_epi32(v, _mm256_permute2x128_si256(v, v, 1));
+            m = _mm256_min_epi32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+            m = _mm256_min_epi32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+            return __builtin_ctz(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, m))));
+        }
+    }
+#endif
+
+    // Function to find the position of the smallest child of position i, or -1 for a leaf
+    int minChild(int i) {
+        int first = i * D + 1;
+        if (first >= _size) {
+            return -1;
+        }
+
+#ifdef __AVX2__
+        // 8-ary and 16-ary heaps of int or float scan full child groups with AVX2
+        if constexpr ((D == 8 || D == 16) && (is_same<T, int>::value || is_same<T, float>::value)) {
+            if (first + D <= _size) {
+                int index = first + minOf8(heap + first);
+                if (D == 16) {
+                    int second = first + 8 + minOf8(heap + first + 8);
+                    if (heap[second].value < heap[index].value) {
+                        index = second;
+                    }
+                }
+                return index;
+            }
+        }
+#endif
+
+        int last = min(_size, first + D);
+        int index = first;
+        for (int j = first + 1; j < last; j++) {
+            if (heap[j].value < heap[index].value) {
+                index = j;
+            }
+        }
+        return index;
+    }
+
+    // Function to grow the arrays geometrically until key index i fits
+    void grow(int i) {
+        if (i == numeric_limits<int>::max()) {
+            throw length_error("Key index too large");
+        }
+        int newCapacity = capacity;
+        while (newCapacity <= i) {
+            // Past half the int range doubling would overflow: take exactly what is needed
+            newCapacity = (newCapacity > numeric_limits<int>::max() / 2) ? i + 1 : 2 * newCapacity;
+        }
+
+        Entry* newHeap = new Entry[newCapacity];
+        int* newPosMap = new int[newCapacity];
+        for (int j = 0; j < newCapacity; j++) {
+            if (j < capacity) {
+                newHeap[j] = heap[j];
+                newPosMap[j] = posMap[j];
+            } else {
+                newPosMap[j] = -1;
+            }
+        }
+
+        delete[] heap;
+        delete[] posMap;
+        heap = newHeap;
+        posMap = newPosMap;
+        capacity = newCapacity;
+    }
+
+    // Function to restore the heap bottom-up in O(n)
+    void heapify() {
+        for (int i = (_size - 2) / D; i >= 0; i--) {
+            sink(i);
+        }
+    }
+
+    // Function to put key index keyIndex at the end of the heap without sifting it
+    void append(int keyIndex, T value) {
+        heap[_size].value = value;
+        heap[_size].key = keyIndex;
+        posMap[keyIndex] = _size;
+        _size++;
+    }
+
+    // Function to take the last entry off the heap
+    void dropLast() {
+        _size--;
+        posMap[heap[_size].key] = -1;
+    }
+
+    // Function to get the value stored for a key index in the queue
+    T& valueRef(int keyIndex) {
+        return heap[posMap[keyIndex]].value;
+    }
+
+    friend struct heapBatch;
+
+    // Function to get the position of a key index that must be in the queue
+    int position(int keyIndex) {
+        if (!contains(keyIndex)) {
+            throw out_of_range("Key not found");
+        }
+        return posMap[keyIndex];
+    }
+
+public:
+    // Constructor to initialize the indexed priority queue with a given capacity;
+    // a growable queue accepts any non-negative key index and grows its arrays as needed
+    leanIndexedPriorityQueue(int _capacity, bool _growable = false) {
+        capacity = max(_capacity, 1);
+        growable = _growable;
+        heap = new Entry[capacity];
+        posMap = new int[capacity];
+        for (int i = 0; i < capacity; i++) {
+            posMap[i] = -1;
+        }
+    }
+
+    // Destructor to deallocate memory
+    ~leanIndexedPriorityQueue() {
+        delete[] heap;
+        delete[] posMap;
+    }
+
+    leanIndexedPriorityQueue(const leanIndexedPriorityQueue&) = delete;
+    leanIndexedPriorityQueue& operator=(const leanIndexedPriorityQueue&) = delete;
+
+    // Function to get the current size of the indexed priority queue
+    int size() {
+        return _size;
+    }
+
+    // Function to remove every key index in O(size), keeping the arrays
+    void clear() {
+        for (int i = 0; i < _size; i++) {
+            posMap[heap[i].key] = -1;
+        }
+        _size = 0;
+    }
+
+    // Function to check if the indexed priority queue is empty
+    bool isEmpty() {
+        return _size == 0;
+    }
+
+    // Function to check if the indexed priority queue contains a key index
+    bool contains(int keyIndex) {
+        return keyIndex >= 0 && keyIndex < capacity && posMap[keyIndex] != -1;
+    }
+
+    // Function to get the key index with the minimum value
+    int peekMinKeyIndex() {
+        return heap[0].key;
+    }
+
+    // Function to remove and return the key index with the minimum value
+    int pollMinKeyIndex() {
+        int minKeyIndex = peekMinKeyIndex();
+        remove(minKeyIndex);
+        return minKeyIndex;
+    }
+
+    // Function to get the minimum value
+    T peekMinvalue() {
+        return heap[0].value;
+    }
+
+    // Function to remove and return the minimum value
+    T pollMinvalue() {
+        return remove(peekMinKeyIndex());
+    }
+
+    // Function to insert a key index with a value into the indexed priority queue
+    void insert(int keyIndex, T value) {
+        if (keyIndex < 0 || (keyIndex >= capacity && !growable)) {
+            throw out_of_range("Key index out of range");
+        }
+        if (keyIndex >= capacity) {
+            grow(keyIndex);
+        }
+        if (contains(keyIndex)) {
+            throw invalid_argument("Key already exists");
+        }
+
+        heap[_size].value = value;
+        heap[_size].key = keyIndex;
+        swim(_size++);
+    }
+
+    // Function to get the value associated with a key index
+    T valueOf(int keyIndex) {
+        return heap[position(keyIndex)].value;
+    }
+
+    // Function to remove a key index from the indexed priority queue and return its value
+    T remove(int keyIndex) {
+        int i = position(keyIndex);
+        T value = heap[i].value;
+        posMap[keyIndex] = -1;
+
+        // Move the last entry into the hole, then restore the heap in whichever direction it needs
+        if (i != --_size) {
+            int moved = heap[_size].key;
+            heap[i] = heap[_size];
+            posMap[moved] = i;
+            sink(i);
+            swim(posMap[moved]);
+        }
+
+        return value;
+    }
+
+    // Function to update the value associated with a key index and return its previous value
+    T update(int keyIndex, T value) {
+        int i = position(keyIndex);
+        T oldValue = heap[i].value;
+        heap[i].value = value;
+        if (value < oldValue) {
+            swim(i);
+        } else {
+            sink(i);
+        }
+
+        return oldValue;
+    }
+
+    // Function to decrease the value associated with a key index
+    void decrease(int keyIndex, T value) {
+        int i = position(keyIndex);
+        if (value < heap[i].value) {
+            heap[i].value = value;
+            swim(i);
+        }
+    }
+
+    // Function to increase the value associated with a key index
+    void increase(int keyIndex, T value) {
+        int i = position(keyIndex);
+        if (heap[i].value < value) {
+            heap[i].value = value;
+            sink(i);
+        }
+    }
+
+    // Function to insert a batch of key indices, rebuilding the heap in O(n) when the batch is large
+    void insertAll(const vector<int>& keys, const vector<T>& values) {
+        heapBatch::insertAll(*this, keys, values);
+    }
+
+    // Function to decrease a batch of values, swimming each lowered entry for small batches and
+    // rebuilding the heap in O(n) for large ones; returns the number of values lowered
+    int decreaseBatch(const vector<int>& keys, const vector<T>& values) {
+        return heapBatch::decreaseBatch(*this, keys, values);
+    }
+};
+
+/**
+ * Dijkstra benchmark on a road-network-like grid: rows x cols intersections, each connected
+ * to its 4 neighbours by roads of random length 1..100.
+ *
+ * @tparam Q The indexed priority queue type to run with.
+ * @return The sum of the shortest distances from the corner (to compare the queues).
+ */
+template <typename Q>
+long long dijkstraGridBenchmark(int rows, int cols, const char* name) {
+    int n = rows * cols;
+    vector<int> start(n + 1, 0), target, weight;
+    unsigned int seed = 77;
+    for (int u = 0; u < n; u++) {
+        int r = u / cols, c = u % cols;
+        int neighbours[4] = { r > 0 ? u - cols : -1, r + 1 < rows ? u + cols : -1, c > 0 ? u - 1 : -1, c + 1 < cols ? u + 1 : -1 };
+        for (int v : neighbours) {
+            if (v != -1) {
+                seed = seed * 1103515245u + 12345u;
+                target.push_back(v);
+                weight.push_back(1 + (seed >> 8) % 100);
+            }
+        }
+        start[u + 1] = (int) target.size();
+    }
+
+    auto begin = chrono::steady_clock::now();
+    vector<int> dist(n, INT32_MAX);
+    Q pq(n);
+    dist[0] = 0;
+    pq.insert(0, 0);
+    while (!pq.isEmpty()) {
+        int u = pq.pollMinKeyIndex();
+        for (int e = start[u]; e < start[u + 1]; e++) {
+            int v = target[e], d = dist[u] + weight[e];
+            if (d < dist[v]) {
+                if (dist[v] == INT32_MAX) {
+                    pq.insert(v, d);
+                } else {
+                    pq.decrease(v, d);
+                }
+                dist[v] = d;
+            }
+        }
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+
+    long long total = 0;
+    for (int d : dist) {
+        total += d;
+    }
+    cout << "Dijkstra " << rows << "x" << cols << " grid, " << name << ": " << elapsed.count() << "s" << endl;
+    return total;
+}
+
+// Indexed priority queue over arbitrary (sparse) keys: keys are mapped to dense slots of a
+// growable indexedPriorityQueue through a denseKeyMap, and slots of removed keys are reused
+template <typename K, typename T>
+class sparseIndexedPriorityQueue {
+    indexedPriorityQueue<T> pq;     // Growable queue over dense slots
+    denseKeyMap<K> slotOf;          // Key -> dense slot
+    vector<K> keyOf;                // Dense slot -> key
+    vector<int> freeSlots;          // Slots released by removed keys
+
+    // Function to get the slot of a key that must be present
+    int slot(const K& key) {
+        int s = slotOf.find(key);
+        if (s == -1) {
+            throw out_of_range("Key not found");
+        }
+        return s;
+    }
+
+public:
+    // Constructor to initialize the queue with a capacity hint
+    sparseIndexedPriorityQueue(int _capacity = 16) : pq(_capacity, true), slotOf(2 * _capacity) {}
+
+    sparseIndexedPriorityQueue(const sparseIndexedPriorityQueue&) = delete;
+    sparseIndexedPriorityQueue& operator=(const sparseIndexedPriorityQueue&) = delete;
+
+    // Function to get the current size of the queue
+    int size() {
+        return pq.size();
+    }
+
+    // Function to check if the queue is empty
+    bool isEmpty() {
+        return pq.isEmpty();
+    }
+
+    // Function to check if the queue contains a key
+    bool contains(const K& key) {
+        return slotOf.find(key) != -1;
+    }
+
+    // Function to insert a key with a value
+    void insert(const K& key, T value) {
+        if (contains(key)) {
+            throw invalid_argument("Key already exists");
+        }
+
+        int s;
+        if (!freeSlots.empty()) {
+            s = freeSlots.back();
+            freeSlots.pop_back();
+            keyOf[s] = key;
+        } else {
+            s = (int) keyOf.size();
+            keyOf.push_back(key);
+        }
+        slotOf.insert(key, s);
+        pq.insert(s, value);
+    }
+
+    // Function to get the value associated with a key
+    T valueOf(const K& key) {
+        return pq.valueOf(slot(key));
+    }
+
+    // Function to remove a key and return its value
+    T remove(const K& key) {
+        int s = slot(key);
+        T value = pq.remove(s);
+        slotOf.erase(key);
+        freeSlots.push_back(s);
+        return value;
+    }
+
+    // Function to get the key with the minimum value
+    K peekMinKey() {
+        if (isEmpty()) {
+            throw out_of_range("Queue is empty");
+        }
+        return keyOf[pq.peekMinKeyIndex()];
+    }
+
+    // Function to remove and return the key with the minimum value
+    K pollMinKey() {
+        K key = peekMinKey();
+        remove(key);
+        return key;
+    }
+
+    // Function to get the minimum value
+    T peekMinvalue() {
+        if (isEmpty()) {
+            throw out_of_range("Queue is empty");
+        }
+        return pq.peekMinvalue();
+    }
+
+    // Function to remove and return the minimum value
+    T pollMinvalue() {
+        return remove(peekMinKey());
+    }
+
+    // Function to update the value associated with a key and return its previous value
+    T update(const K& key, T value) {
+        return pq.update(slot(key), value);
+    }
+
+    // Function to decrease the value associated with a key
+    void decrease(const K& key, T value) {
+        pq.decrease(slot(key), value);
+    }
+
+    // Function to increase the value associated with a key
+    void increase(const K& key, T value) {
+        pq.increase(slot(key), value);
+    }
 };
 
+// Weighted graph in compressed sparse row form: the edges leaving vertex u are
+// targets[offsets[u] .. offsets[u + 1]) with the matching weights
+template <typename W = long long>
+class csrGraph {
+    int n = 0;                  // Number of vertices
+    bool directed = true;       // Whether edges were added in one direction only
+    vector<int> offsets;        // Start of each vertex's edge range (n + 1 entries)
+    vector<int> targets;        // Edge targets
+    vector<W> weights;          // Edge weights
+
+public:
+    // Constructor to build the graph from (from, to, weight) edges; undirected graphs store both directions
+    csrGraph(int _n, const vector<tuple<int, int, W>>& edges, bool _directed = true) {
+        n = _n;
+        directed = _directed;
+        offsets.assign(n + 1, 0);
+
+        // Counting sort of the edges by source vertex
+        for (auto& edge : edges) {
+            if (get<0>(edge) < 0 || get<0>(edge) >= n || get<1>(edge) < 0 || get<1>(edge) >= n) {
+                throw out_of_range("Edge endpoint out of range");
+            }
+            offsets[get<0>(edge) + 1]++;
+            if (!directed) {
+                offsets[get<1>(edge) + 1]++;
+            }
+        }
+        for (int u = 0; u < n; u++) {
+            offsets[u + 1] += offsets[u];
+        }
+
+        targets.resize(offsets[n]);
+        weights.resize(offsets[n]);
+        vector<int> next(offsets.begin(), offsets.end() - 1);
+        for (auto& edge : edges) {
+            int u = get<0>(edge), v = get<1>(edge);
+            targets[next[u]] = v;
+            weights[next[u]++] = get<2>(edge);
+            if (!directed) {
+                targets[next[v]] = u;
+                weights[next[v]++] = get<2>(edge);
+            }
+        }
+    }
+
+    /**
+     * Loads a graph from a text edge list: one "from to weight" triple per line,
+     * blank lines and lines starting with '#' are skipped. The vertex count is the
+     * largest vertex id + 1.
+     *
+     * @param path The edge list file.
+     * @param directed Whether each line is a one-way edge.
+     * @return The graph.
+     */
+    static csrGraph fromFile(const string& path, bool directed = true) {
+        ifstream in(path);
+        if (!in) {
+            throw runtime_error("Cannot open edge list " + path);
+        }
+
+        vector<tuple<int, int, W>> edges;
+        int n = 0;
+        string line;
+        while (getline(in, line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == string::npos || line[first] == '#') {
+                continue;
+            }
+            istringstream fields(line);
+            int u, v;
+            W w;
+            if (!(fields >> u >> v >> w)) {
+                throw runtime_error("Malformed edge line: " + line);
+            }
+            edges.emplace_back(u, v, w);
+            n = max(n, max(u, v) + 1);
+        }
+
+        return csrGraph(n, edges, directed);
+    }
+
+    // Function to get the graph with every edge reversed
+    csrGraph reversed() const {
+        vector<tuple<int, int, W>> edges;
+        for (int u = 0; u < n; u++) {
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                edges.emplace_back(targets[e], u, weights[e]);
+            }
+        }
+        return csrGraph(n, edges, true);
+    }
+
+    // Function to get the number of vertices
+    int vertices() const {
+        return n;
+    }
+
+    // Function to get the number of stored (directed) edges
+    int edges() const {
+        return offsets[n];
+    }
+
+    // Function to check if the graph is directed
+    bool isDirected() const {
+        return directed;
+    }
+
+    // Functions to walk the edges leaving u: for (int e = begin(u); e < end(u); e++)
+    int begin(int u) const {
+        return offsets[u];
+    }
+
+    int end(int u) const {
+        return offsets[u + 1];
+    }
+
+    int target(int e) const {
+        return targets[e];
+    }
+
+    W weight(int e) const {
+        return weights[e];
+    }
+};
+
+// Shortest path and spanning tree queries over a csrGraph. The engine owns its priority
+// queues and label arrays and reuses them between queries: only the vertices touched by the
+// previous query are reset, so a query costs time proportional to the part of the graph it explores.
+// Q defaults to leanIndexedPriorityQueue<W, 4> rather than indexedPriorityQueue<W>: it keeps two
+// arrays instead of five and compares values in place, which runs the grid Dijkstra benchmark in
+// main about 1.7x faster, and four 16-byte (long long, key) entries fill one cache line. Any queue
+// with the same interface can be passed instead, indexedPriorityQueue<W> included.
+template <typename W = long long, typename Q = leanIndexedPriorityQueue<W, 4>>
+class shortestPathEngine {
+    const csrGraph<W>& graph;       // Graph queried (forward direction)
+    csrGraph<W>* reversedGraph;     // Reversed graph for backward searches (null when undirected)
+    int n;                          // Number of vertices
+    Q forwardQueue, backwardQueue;  // Reused priority queues
+    vector<W> forwardDist, backwardDist;        // Tentative distances (INF = unreached)
+    vector<int> forwardParent;                  // Predecessors of the last forward search
+    vector<int> forwardTouched, backwardTouched;// Vertices whose labels must be reset
+    bool hasSearch = false;     // Whether the forward labels come from a dijkstra or aStar search
+
+    // Function to reset the labels of the previous query
+    void reset() {
+        hasSearch = false;
+        for (int v : forwardTouched) {
+            forwardDist[v] = INF;
+            forwardParent[v] = -1;
+        }
+        for (int v : backwardTouched) {
+            backwardDist[v] = INF;
+        }
+        forwardTouched.clear();
+        backwardTouched.clear();
+        forwardQueue.clear();
+        backwardQueue.clear();
+    }
+
+    // Function to lower the label of v through insert or decrease on the queue
+    static void relax(Q& pq, int v, W key) {
+        if (!pq.contains(v)) {
+            pq.insert(v, key);
+        } else {
+            pq.decrease(v, key);
+        }
+    }
+
+    // Function to check that a vertex id is valid
+    void check(int v) {
+        if (v < 0 || v >= n) {
+            throw out_of_range("Vertex out of range");
+        }
+    }
+
+    // Function to run Dijkstra from source until target is settled
+    // (target = -1: until the queue is empty)
+    W search(int source, int target) {
+        check(source);
+        reset();
+        hasSearch = true;
+        forwardDist[source] = 0;
+        forwardTouched.push_back(source);
+        forwardQueue.insert(source, 0);
+
+        while (!forwardQueue.isEmpty()) {
+            int u = forwardQueue.pollMinKeyIndex();
+            if (u == target) {
+                return forwardDist[u];
+            }
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.target(e);
+                W d = forwardDist[u] + graph.weight(e);
+                if (d < forwardDist[v]) {
+                    if (forwardDist[v] == INF) {
+                        forwardTouched.push_back(v);
+                    }
+                    forwardDist[v] = d;
+                    forwardParent[v] = u;
+                    relax(forwardQueue, v, d);
+                }
+            }
+        }
+
+        return INF;
+    }
+
+    // Function to check that distance() and path() have a shortest path search to read
+    void checkSearch() {
+        if (!hasSearch) {
+            throw logic_error("No dijkstra or aStar search to read distances from");
+        }
+    }
+
+public:
+    static constexpr W INF = numeric_limits<W>::max();
+
+    // Constructor to create an engine for a graph; the graph must outlive the engine
+    shortestPathEngine(const csrGraph<W>& _graph)
+        : graph(_graph), reversedGraph(nullptr), n(_graph.vertices()),
+          forwardQueue(max(1, _graph.vertices())), backwardQueue(max(1, _graph.vertices())),
+          forwardDist(_graph.vertices(), INF), backwardDist(_graph.vertices(), INF),
+          forwardParent(_graph.vertices(), -1) {
+        if (graph.isDirected()) {
+            reversedGraph = new csrGraph<W>(graph.reversed());
+        }
+    }
+
+    // Destructor to deallocate the reversed graph
+    ~shortestPathEngine() {
+        delete reversedGraph;
+    }
+
+    shortestPathEngine(const shortestPathEngine&) = delete;
+    shortestPathEngine& operator=(const shortestPathEngine&) = delete;
+
+    // Function to run Dijkstra from source over the whole graph; distance() and path() then
+    // answer any vertex
+    void dijkstraAll(int source) {
+        search(source, -1);
+    }
+
+    /**
+     * Dijkstra from source to target. Stops as soon as target is settled.
+     *
+     * @return The distance to target (INF if unreachable).
+     */
+    W dijkstra(int source, int target) {
+        check(target);
+        return search(source, target);
+    }
+
+    /**
+     * A* from source to target. The heuristic h(v) must never overestimate the distance
+     * from v to target; with a consistent heuristic every vertex is expanded at most once.
+     *
+     * @return The distance to target (INF if unreachable).
+     */
+    template <typename H>
+    W aStar(int source, int target, H heuristic) {
+        check(source);
+        check(target);
+        reset();
+        hasSearch = true;
+        forwardDist[source] = 0;
+        forwardTouched.push_back(source);
+        forwardQueue.insert(source, heuristic(source));
+
+        while (!forwardQueue.isEmpty()) {
+            int u = forwardQueue.pollMinKeyIndex();
+            if (u == target) {
+                return forwardDist[u];
+            }
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.target(e);
+                W d = forwardDist[u] + graph.weight(e);
+                if (d < forwardDist[v]) {
+                    if (forwardDist[v] == INF) {
+                        forwardTouched.push_back(v);
+                    }
+                    forwardDist[v] = d;
+                    forwardParent[v] = u;
+                    relax(forwardQueue, v, d + heuristic(v));
+                }
+            }
+        }
+
+        return INF;
+    }
+
+    /**
+     * Bidirectional Dijkstra: searches forward from source and backward from target,
+     * always expanding the side with the smaller queue minimum, and stops once the two
+     * minima together cannot beat the best meeting point found.
+     *
+     * @return The distance from source to target (INF if unreachable).
+     */
+    W bidirectionalDijkstra(int source, int target) {
+        check(source);
+        check(target);
+        reset();
+        const csrGraph<W>& backwardGraph = reversedGraph != nullptr ? *reversedGraph : graph;
+
+        forwardDist[source] = 0;
+        backwardDist[target] = 0;
+        forwardTouched.push_back(source);
+        backwardTouched.push_back(target);
+        forwardQueue.insert(source, 0);
+        backwardQueue.insert(target, 0);
+        W best = source == target ? 0 : INF;
+
+        while (!forwardQueue.isEmpty() && !backwardQueue.isEmpty()) {
+            W forwardMin = forwardQueue.peekMinvalue();
+            W backwardMin = backwardQueue.peekMinvalue();
+            if (best != INF && forwardMin + backwardMin >= best) {
+                break;
+            }
+
+            bool forward = forwardMin <= backwardMin;
+            const csrGraph<W>& g = forward ? graph : backwardGraph;
+            Q& pq = forward ? forwardQueue : backwardQueue;
+            vector<W>& dist = forward ? forwardDist : backwardDist;
+            vector<W>& other = forward ? backwardDist : forwardDist;
+            vector<int>& touched = forward ? forwardTouched : backwardTouched;
+
+            int u = pq.pollMinKeyIndex();
+            for (int e = g.begin(u); e < g.end(u); e++) {
+                int v = g.target(e);
+                W d = dist[u] + g.weight(e);
+                if (d < dist[v]) {
+                    if (dist[v] == INF) {
+                        touched.push_back(v);
+                    }
+                    dist[v] = d;
+                    if (forward) {
+                        forwardParent[v] = u;
+                    }
+                    relax(pq, v, d);
+                }
+                if (other[v] != INF && dist[v] + other[v] < best) {
+                    best = dist[v] + other[v];
+                }
+            }
+        }
+
+        return best;
+    }
+
+    /**
+     * Many-to-many batch query: one Dijkstra per source that stops when every target is
+     * settled, all reusing the same queue and label memory.
+     *
+     * @return The |sources| x |targets| distance matrix in row-major order (INF = unreachable).
+     */
+    vector<W> manyToMany(const vector<int>& sources, const vector<int>& targets) {
+        vector<W> result(sources.size() * targets.size(), INF);
+        vector<char> isTarget(n, 0);
+        for (int t : targets) {
+            check(t);
+            isTarget[t] = 1;
+        }
+        int distinctTargets = 0;
+        for (int v = 0; v < n; v++) {
+            distinctTargets += isTarget[v];
+        }
+
+        for (size_t s = 0; s < sources.size(); s++) {
+            check(sources[s]);
+            reset();
+            forwardDist[sources[s]] = 0;
+            forwardTouched.push_back(sources[s]);
+            forwardQueue.insert(sources[s], 0);
+
+            int remaining = distinctTargets;
+            while (!forwardQueue.isEmpty() && remaining > 0) {
+                int u = forwardQueue.pollMinKeyIndex();
+                remaining -= isTarget[u];
+                for (int e = graph.begin(u); e < graph.end(u); e++) {
+                    int v = graph.target(e);
+                    W d = forwardDist[u] + graph.weight(e);
+                    if (d < forwardDist[v]) {
+                        if (forwardDist[v] == INF) {
+                            forwardTouched.push_back(v);
+                        }
+                        forwardDist[v] = d;
+                        forwardParent[v] = u;
+                        relax(forwardQueue, v, d);
+                    }
+                }
+            }
+
+            for (size_t t = 0; t < targets.size(); t++) {
+                result[s * targets.size() + t] = forwardDist[targets[t]];
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Prim's algorithm over an undirected graph; disconnected graphs give a spanning forest.
+     * The labels it leaves are edge weights, not distances, so they are cleared on return.
+     *
+     * @param parent Receives the tree parent of every vertex (-1 for the roots).
+     * @return The total weight of the minimum spanning forest.
+     */
+    W prim(vector<int>& parent) {
+        if (graph.isDirected()) {
+            throw invalid_argument("Prim needs an undirected graph");
+        }
+        reset();
+        parent.assign(n, -1);
+        vector<char> inTree(n, 0);
+        W total = 0;
+
+        for (int root = 0; root < n; root++) {
+            if (inTree[root]) {
+                continue;
+            }
+            forwardQueue.insert(root, 0);
+            forwardDist[root] = 0;
+            forwardTouched.push_back(root);
+
+            while (!forwardQueue.isEmpty()) {
+                total += forwardQueue.peekMinvalue();
+                int u = forwardQueue.pollMinKeyIndex();
+                inTree[u] = 1;
+                for (int e = graph.begin(u); e < graph.end(u); e++) {
+                    int v = graph.target(e);
+                    W w = graph.weight(e);
+                    if (!inTree[v] && w < forwardDist[v]) {
+                        if (forwardDist[v] == INF) {
+                            forwardTouched.push_back(v);
+                        }
+                        forwardDist[v] = w;
+                        parent[v] = u;
+                        relax(forwardQueue, v, w);
+                    }
+                }
+            }
+        }
+
+        reset();
+        return total;
+    }
+
+    // Function to get the distance of a vertex after dijkstraAll() (or of a settled vertex
+    // after dijkstra() or aStar()); throws if the last query was another kind
+    W distance(int v) {
+        check(v);
+        checkSearch();
+        return forwardDist[v];
+    }
+
+    // Function to get the path from the source of the last dijkstraAll(), dijkstra() or aStar()
+    // call to target; throws if the last query was another kind
+    vector<int> path(int target) {
+        check(target);
+        checkSearch();
+        vector<int> result;
+        if (forwardDist[target] == INF) {
+            return result;
+        }
+        for (int v = target; v != -1; v = forwardParent[v]) {
+            result.push_back(v);
+        }
+        reverse(result.begin(), result.end());
+        return result;
+    }
+};
+
+/**
+ * Query latency benchmark on a rows x cols grid: random source/target pairs answered with
+ * early-exit Dijkstra, bidirectional Dijkstra and A* (Manhattan distance, roads are at least 1 long).
+ */
+void queryLatencyBenchmark(int rows, int cols, int queries) {
+    vector<tuple<int, int, long long>> edges;
+    unsigned int seed = 321;
+    for (int u = 0; u < rows * cols; u++) {
+        if ((u + 1) % cols != 0) {
+            seed = seed * 1103515245u + 12345u;
+            edges.emplace_back(u, u + 1, 1 + (seed >> 8) % 10);
+        }
+        if (u + cols < rows * cols) {
+            seed = seed * 1103515245u + 12345u;
+            edges.emplace_back(u, u + cols, 1 + (seed >> 8) % 10);
+        }
+    }
+    csrGraph<long long> grid(rows * cols, edges, false);
+    shortestPathEngine<long long> engine(grid);
+
+    vector<pair<int, int>> pairs;
+    for (int i = 0; i < queries; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int s = (seed >> 4) % (rows * cols);
+        seed = seed * 1103515245u + 12345u;
+        pairs.push_back({s, (int) ((seed >> 4) % (rows * cols))});
+    }
+
+    vector<long long> answers[3];
+    const char* names[3] = { "Dijkstra", "bidirectional Dijkstra", "A*" };
+    for (int method = 0; method < 3; method++) {
+        auto begin = chrono::steady_clock::now();
+        for (auto& query : pairs) {
+            int target = query.second;
+            if (method == 0) {
+                answers[method].push_back(engine.dijkstra(query.first, target));
+            } else if (method == 1) {
+                answers[method].push_back(engine.bidirectionalDijkstra(query.first, target));
+            } else {
+                answers[method].push_back(engine.aStar(query.first, target, [cols, target](int v) {
+                    return (long long) (abs(v / cols - target / cols) + abs(v % cols - target % cols));
+                }));
+            }
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+        cout << names[method] << ": " << elapsed.count() * 1e6 / queries << " us/query" << endl;
+    }
+    assert(answers[0] == answers[1] && answers[0] == answers[2]);
+}
+
 int main() {
     // Test case 1
     indexedPriorityQueue<int> pq1(5);
@@ -252,6 +1502,325 @@ int main() {
     assert(oldValue == 2);
     assert(pq7.peekMinvalue() == 3);
 
+    // Test case 8: Growable queue accepts key indices past the initial capacity
+    indexedPriorityQueue<int> pq8(3, true);
+    for (int i = 0; i < 100; i++) {
+        pq8.insert(i * 7, 1000 - i);
+    }
+    assert(pq8.size() == 100);
+    assert(pq8.contains(693) && !pq8.contains(694) && !pq8.contains(100000));
+    for (int i = 99; i >= 0; i--) {
+        assert(pq8.pollMinKeyIndex() == i * 7);
+    }
+    bool tooLarge = false;
+    try {
+        pq8.insert(numeric_limits<int>::max(), 1);
+    } catch (length_error&) {
+        tooLarge = true;
+    }
+    assert(tooLarge && pq8.isEmpty());
+
+    // Test case 9: Fixed-capacity queue rejects key indices out of range
+    indexedPriorityQueue<int> pq9(5);
+    bool thrown = false;
+    try {
+        pq9.insert(5, 1);
+    } catch (out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Test case 10: Removing a key keeps the remaining heap intact
+    indexedPriorityQueue<int> pq10(5);
+    pq10.insert(0, 5);
+    pq10.insert(1, 2);
+    pq10.insert(2, 7);
+    pq10.insert(3, 1);
+    assert(pq10.remove(0) == 5);
+    assert(pq10.pollMinKeyIndex() == 3);
+    assert(pq10.pollMinKeyIndex() == 1);
+    assert(pq10.pollMinKeyIndex() == 2);
+
+    // Test case 11: Sparse 64-bit keys with slot recycling
+    sparseIndexedPriorityQueue<long long, double> spq;
+    spq.insert(1LL << 40, 2.5);
+    spq.insert(-7, 1.5);
+    spq.insert(123456789012LL, 3.5);
+    assert(spq.peekMinKey() == -7);
+    assert(spq.peekMinvalue() == 1.5);
+    spq.decrease(123456789012LL, 0.5);
+    assert(spq.pollMinKey() == 123456789012LL);
+    assert(!spq.contains(123456789012LL));
+    spq.insert(42, 0.25);
+    assert(spq.valueOf(42) == 0.25);
+    assert(spq.pollMinvalue() == 0.25);
+    assert(spq.size() == 2);
+
+    // Test case 12: Sparse keys against a sorted reference, with many removals
+    sparseIndexedPriorityQueue<unsigned long long, int> spq2(4);
+    unsigned long long seed = 3;
+    vector<pair<int, unsigned long long>> reference;
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        unsigned long long key = seed;
+        int value = (int) (seed >> 40) % 1000;
+        spq2.insert(key, value * 2000 + i);
+        reference.push_back({value * 2000 + i, key});
+    }
+    for (int i = 0; i < 2000; i += 3) {
+        spq2.remove(reference[i].second);
+        reference[i].first = -1;
+    }
+    vector<pair<int, unsigned long long>> remaining;
+    for (auto& entry : reference) {
+        if (entry.first != -1) {
+            remaining.push_back(entry);
+        }
+    }
+    sort(remaining.begin(), remaining.end());
+    for (auto& entry : remaining) {
+        assert(spq2.pollMinKey() == entry.second);
+    }
+    assert(spq2.isEmpty());
+
+    // Test case 13: Lean layout against the default layout on random operations
+    indexedPriorityQueue<int> classic(1000);
+    leanIndexedPriorityQueue<int, 4> lean(1000);
+    unsigned int leanSeed = 11;
+    for (int i = 0; i < 50000; i++) {
+        leanSeed = leanSeed * 1103515245u + 12345u;
+        int key = (leanSeed >> 8) % 1000;
+        int value = (leanSeed >> 4) % 100000;
+        if (!classic.contains(key)) {
+            classic.insert(key, value);
+            lean.insert(key, value);
+        } else if (i % 3 == 0) {
+            classic.decrease(key, value);
+            lean.decrease(key, value);
+        } else if (i % 3 == 1) {
+            assert(classic.remove(key) == lean.remove(key));
+        } else {
+            assert(classic.update(key, value) == lean.update(key, value));
+        }
+        assert(classic.size() == lean.size());
+        if (!lean.isEmpty()) {
+            assert(classic.peekMinvalue() == lean.peekMinvalue());
+            assert(lean.valueOf(lean.peekMinKeyIndex()) == lean.peekMinvalue());
+        }
+    }
+    while (!lean.isEmpty()) {
+        assert(classic.pollMinvalue() == lean.pollMinvalue());
+    }
+
+    // Test case 14: Growable lean queue
+    leanIndexedPriorityQueue<double> leanGrowable(2, true);
+    leanGrowable.insert(1000, 3.0);
+    leanGrowable.insert(5, 1.0);
+    leanGrowable.increase(5, 4.0);
+    assert(leanGrowable.pollMinKeyIndex() == 1000);
+    assert(leanGrowable.pollMinvalue() == 4.0);
+    bool leanTooLarge = false;
+    try {
+        leanGrowable.insert(numeric_limits<int>::max(), 1.0);
+    } catch (length_error&) {
+        leanTooLarge = true;
+    }
+    assert(leanTooLarge && leanGrowable.isEmpty());
+
+    // Decrease-key benchmark: default layout vs lean layout
+    int benchKeys = 1 << 20, benchOps = 1 << 21;
+    indexedPriorityQueue<int> classicBench(benchKeys);
+    leanIndexedPriorityQueue<int> leanBench(benchKeys);
+    vector<int> benchValues(benchKeys);
+    for (int i = 0; i < benchKeys; i++) {
+        leanSeed = leanSeed * 1103515245u + 12345u;
+        benchValues[i] = 1000000000 + (int) (leanSeed >> 4);
+        classicBench.insert(i, benchValues[i]);
+        leanBench.insert(i, benchValues[i]);
+    }
+    auto benchStart = chrono::steady_clock::now();
+    unsigned int classicSeed = leanSeed;
+    for (int i = 0; i < benchOps; i++) {
+        classicSeed = classicSeed * 1103515245u + 12345u;
+        int key = (classicSeed >> 4) % benchKeys;
+        classicBench.decrease(key, classicBench.valueOf(key) - (int) (classicSeed % 1000000));
+    }
+    chrono::duration<double> classicTime = chrono::steady_clock::now() - benchStart;
+    benchStart = chrono::steady_clock::now();
+    unsigned int leanBenchSeed = leanSeed;
+    for (int i = 0; i < benchOps; i++) {
+        leanBenchSeed = leanBenchSeed * 1103515245u + 12345u;
+        int key = (leanBenchSeed >> 4) % benchKeys;
+        leanBench.decrease(key, leanBench.valueOf(key) - (int) (leanBenchSeed % 1000000));
+    }
+    chrono::duration<double> leanTime = chrono::steady_clock::now() - benchStart;
+    assert(classicBench.peekMinvalue() == leanBench.peekMinvalue());
+    cout << "decrease-key: default layout " << classicTime.count() << "s (" << (16 + sizeof(int)) * benchKeys / (1 << 20)
+         << " MB), lean layout " << leanTime.count() << "s (" << (4 + 2 * sizeof(int)) * benchKeys / (1 << 20) << " MB)" << endl;
+
+    // Test case 15: 8-ary and 16-ary lean queues (AVX2 min-child scan when compiled with it)
+    leanIndexedPriorityQueue<int, 8> wideInt(5000);
+    leanIndexedPriorityQueue<float, 16> wideFloat(5000);
+    leanIndexedPriorityQueue<int> binaryInt(5000);
+    for (int i = 0; i < 5000; i++) {
+        leanSeed = leanSeed * 1103515245u + 12345u;
+        int value = (int) (leanSeed >> 12) % 3000 - 1500;
+        wideInt.insert(i, value);
+        wideFloat.insert(i, value * 0.5f);
+        binaryInt.insert(i, value);
+    }
+    for (int i = 0; i < 5000; i += 2) {
+        wideInt.increase(i, 100000 - i);
+        wideFloat.increase(i, (100000 - i) * 0.5f);
+        binaryInt.increase(i, 100000 - i);
+    }
+    while (!binaryInt.isEmpty()) {
+        int expected = binaryInt.pollMinvalue();
+        assert(wideInt.pollMinvalue() == expected);
+        assert(wideFloat.pollMinvalue() == expected * 0.5f);
+    }
+
+    // Dijkstra benchmark: binary default layout vs lean binary vs lean 8-ary / 16-ary
+    long long expectedTotal = dijkstraGridBenchmark<indexedPriorityQueue<int>>(1000, 1000, "indexedPriorityQueue (binary)");
+    long long leanBinaryTotal = dijkstraGridBenchmark<leanIndexedPriorityQueue<int>>(1000, 1000, "lean, D = 2");
+    long long lean8Total = dijkstraGridBenchmark<leanIndexedPriorityQueue<int, 8>>(1000, 1000, "lean, D = 8");
+    long long lean16Total = dijkstraGridBenchmark<leanIndexedPriorityQueue<int, 16>>(1000, 1000, "lean, D = 16");
+    assert(leanBinaryTotal == expectedTotal && lean8Total == expectedTotal && lean16Total == expectedTotal);
+
+    // Test case 16: CSR graph and shortest path engine
+    vector<tuple<int, int, long long>> roads = {
+        {0, 1, 4}, {0, 2, 1}, {2, 1, 2}, {1, 3, 1}, {2, 3, 5}, {3, 4, 3}, {5, 4, 1}
+    };
+    const long long INF = shortestPathEngine<long long>::INF;
+    csrGraph<long long> directedRoads(6, roads);
+    shortestPathEngine<long long> engine(directedRoads);
+    engine.dijkstraAll(0);
+    assert(engine.distance(1) == 3 && engine.distance(3) == 4 && engine.distance(4) == 7);
+    assert(engine.distance(5) == INF);
+    assert(engine.path(4) == vector<int>({0, 2, 1, 3, 4}));
+    assert(engine.dijkstra(0, 3) == 4);
+    assert(engine.dijkstra(4, 0) == INF);
+    assert(engine.bidirectionalDijkstra(0, 4) == 7);
+    assert(engine.bidirectionalDijkstra(2, 2) == 0);
+    assert(engine.bidirectionalDijkstra(4, 0) == INF);
+    assert(engine.aStar(0, 4, [](int) { return 0LL; }) == 7);
+    vector<long long> matrix = engine.manyToMany({0, 2}, {3, 4, 5});
+    assert(matrix == vector<long long>({4, 7, INF, 3, 6, INF}));
+
+    // Test case 17: Loading an edge list file and running Prim on the undirected graph
+    const char* edgeFile = "indexedPriorityQueue_edges.txt";
+    {
+        ofstream out(edgeFile);
+        out << "# from to weight\n0 1 4\n0 2 1\n2 1 2\n\n1 3 1\n2 3 5\n3 4 3\n5 4 1\n";
+    }
+    csrGraph<long long> loaded = csrGraph<long long>::fromFile(edgeFile, false);
+    std::remove(edgeFile);
+    assert(loaded.vertices() == 6 && loaded.edges() == 14);
+    shortestPathEngine<long long> undirected(loaded);
+    vector<int> treeParent;
+    assert(undirected.prim(treeParent) == 8);
+    assert(treeParent[0] == -1 && treeParent[2] == 0 && treeParent[1] == 2 && treeParent[5] == 4);
+    bool primLabelsRead = false;
+    try {
+        undirected.distance(3);     // Prim's labels are edge weights, not distances
+    } catch (logic_error&) {
+        primLabelsRead = true;
+    }
+    assert(primLabelsRead);
+    undirected.dijkstraAll(0);
+    assert(undirected.distance(3) == 4 && undirected.path(4) == vector<int>({0, 2, 1, 3, 4}));
+    assert(undirected.bidirectionalDijkstra(5, 0) == 8);
+
+    // Test case 18: Batch queries agree with single queries and the engine can use either queue
+    shortestPathEngine<long long, indexedPriorityQueue<long long>> classicEngine(loaded);
+    vector<long long> all = undirected.manyToMany({0, 1, 2, 3, 4, 5}, {0, 1, 2, 3, 4, 5});
+    for (int s = 0; s < 6; s++) {
+        for (int t = 0; t < 6; t++) {
+            assert(all[s * 6 + t] == classicEngine.dijkstra(s, t));
+        }
+    }
+
+    // Test case 19: Bulk load and batch decrease on both layouts, small and large batches
+    for (int batch : {10, 4000}) {
+        indexedPriorityQueue<int> bulkClassic(5000);
+        leanIndexedPriorityQueue<int, 4> bulkLean(5000);
+        vector<int> bulkKeys, bulkValues;
+        for (int i = 0; i < 5000; i++) {
+            leanSeed = leanSeed * 1103515245u + 12345u;
+            bulkKeys.push_back(i);
+            bulkValues.push_back((leanSeed >> 8) % 100000);
+        }
+        bulkClassic.insertAll(bulkKeys, bulkValues);
+        bulkLean.insertAll(bulkKeys, bulkValues);
+
+        vector<int> lowerKeys, lowerValues;
+        for (int i = 0; i < batch; i++) {
+            leanSeed = leanSeed * 1103515245u + 12345u;
+            int key = (leanSeed >> 8) % 5000;
+            lowerKeys.push_back(key);
+            lowerValues.push_back(bulkValues[key] - (int) (leanSeed % 50000));
+            bulkValues[key] = min(bulkValues[key], lowerValues.back());
+        }
+        int lowered = bulkClassic.decreaseBatch(lowerKeys, lowerValues);
+        assert(bulkLean.decreaseBatch(lowerKeys, lowerValues) == lowered);
+
+        sort(bulkValues.begin(), bulkValues.end());
+        for (int value : bulkValues) {
+            assert(bulkClassic.pollMinvalue() == value);
+            assert(bulkLean.pollMinvalue() == value);
+        }
+    }
+
+    // Test case 20: Bulk load into a non-empty queue and duplicate keys in a batch
+    leanIndexedPriorityQueue<int> mixed(10);
+    mixed.insert(3, 30);
+    mixed.insertAll({1, 2}, {20, 10});
+    assert(mixed.pollMinKeyIndex() == 2 && mixed.pollMinKeyIndex() == 1);
+    thrown = false;
+    try {
+        mixed.insertAll({4, 5, 4}, {1, 2, 3});
+    } catch (invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && mixed.size() == 1 && !mixed.contains(4) && mixed.peekMinKeyIndex() == 3);
+    thrown = false;
+    try {
+        mixed.insert(0, 0);
+        mixed.insertAll({4}, {50});
+        mixed.insert(6, 60);
+        mixed.remove(0);
+        mixed.insertAll({5}, {1});
+        assert(mixed.pollMinKeyIndex() == 5);
+        mixed.insertAll({1, 2, 7}, {9, 8, 7});
+        mixed.insertAll({8, 8}, {5, 5});
+    } catch (invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && mixed.size() == 6 && !mixed.contains(8));
+    assert(mixed.pollMinvalue() == 7 && mixed.pollMinvalue() == 8 && mixed.pollMinvalue() == 9);
+
+    // Bulk load benchmark: one insert per key vs insertAll
+    vector<int> loadKeys(benchKeys), loadValues(benchKeys);
+    for (int i = 0; i < benchKeys; i++) {
+        leanSeed = leanSeed * 1103515245u + 12345u;
+        loadKeys[i] = i;
+        loadValues[i] = (int) (leanSeed >> 4);
+    }
+    leanIndexedPriorityQueue<int> oneByOne(benchKeys), bulk(benchKeys);
+    benchStart = chrono::steady_clock::now();
+    for (int i = 0; i < benchKeys; i++) {
+        oneByOne.insert(loadKeys[i], loadValues[i]);
+    }
+    chrono::duration<double> oneByOneTime = chrono::steady_clock::now() - benchStart;
+    benchStart = chrono::steady_clock::now();
+    bulk.insertAll(loadKeys, loadValues);
+    chrono::duration<double> bulkTime = chrono::steady_clock::now() - benchStart;
+    assert(oneByOne.peekMinvalue() == bulk.peekMinvalue());
+    cout << "bulk load of " << benchKeys << " keys: insert " << oneByOneTime.count() << "s, insertAll " << bulkTime.count() << "s" << endl;
+
+    // Query latency on a road-like grid
+    queryLatencyBenchmark(300, 300, 200);
+
     cout << "All test cases passed!" << endl;
 
     return 0;
@@ -0,0 +1,321 @@
+/*
+    Author: Seif Ibrahim
+    Description: Leftist Heap Data Strcture implementation
+                 (mergeable min heap with arena-allocated nodes)
+
+    Last Updated: 19/10/2026
+
+    Github: Seif-Ibrahim1
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+
+using namespace std;
+
+// Node of a leftist heap; rank is the length of the right spine (null path length)
+template <typename T>
+struct LeftistNode {
+    T value;
+    int rank;
+    LeftistNode* left;
+    LeftistNode* right;
+};
+
+// Slab arena handing out fixed-size nodes; freed nodes go to a free list and are reused.
+// Heaps that are melded together must share the same arena.
+template <typename T>
+class NodeArena {
+    vector<LeftistNode<T>*> slabs;      // Allocated slabs
+    LeftistNode<T>* freeList = nullptr; // Singly linked (through left) list of free nodes
+    int slabSize;                       // Number of nodes in the next slab
+
+    // Function to allocate a new slab and push its nodes on the free list
+    void grow() {
+        LeftistNode<T>* slab = new LeftistNode<T>[slabSize];
+        slabs.push_back(slab);
+        for (int i = slabSize - 1; i >= 0; i--) {
+            slab[i].left = freeList;
+            freeList = &slab[i];
+        }
+        slabSize *= 2;
+    }
+
+public:
+    // Constructor for the NodeArena class
+    NodeArena(int firstSlab = 64) {
+        slabSize = max(1, firstSlab);
+    }
+
+    // Destructor to deallocate every slab
+    ~NodeArena() {
+        for (LeftistNode<T>* slab : slabs) {
+            delete[] slab;
+        }
+    }
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    // Function to get a node initialized with a value
+    LeftistNode<T>* allocate(const T& value) {
+        if (freeList == nullptr) {
+            grow();
+        }
+        LeftistNode<T>* node = freeList;
+        freeList = node->left;
+        node->value = value;
+        node->rank = 1;
+        node->left = node->right = nullptr;
+        return node;
+    }
+
+    // Function to give a node back to the arena
+    void release(LeftistNode<T>* node) {
+        node->left = freeList;
+        freeList = node;
+    }
+};
+
+// LeftistHeap class: a min heap supporting O(log n) meld of two heaps
+template <typename T>
+class LeftistHeap {
+    typedef LeftistNode<T> Node;
+
+    static const int MAX_PATH = 128;    // Bound on the sum of two right spine lengths
+
+    NodeArena<T>* arena;        // Arena the nodes come from (shared between melded heaps)
+    bool ownsArena;             // Whether this heap created (and must delete) its arena
+    Node* root = nullptr;       // Root of the heap
+    int size = 0;               // Current number of elements in the heap
+
+    // Function to get the rank of a possibly null node
+    static int rankOf(Node* node) {
+        return node == nullptr ? 0 : node->rank;
+    }
+
+    // Function to merge two heaps iteratively: walk down the right spines merging them,
+    // then walk back up fixing ranks and swapping children. A right spine of a leftist heap
+    // with n nodes has at most log2(n + 1) nodes, so the merge path fits a fixed array and
+    // neither recursion nor allocation is needed.
+    static Node* merge(Node* a, Node* b) {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+
+        Node* path[MAX_PATH];
+        int length = 0;
+        if (b->value < a->value) {
+            swap(a, b);
+        }
+        Node* result = a;
+
+        // a is the node whose right subtree is being merged with b
+        while (true) {
+            path[length++] = a;
+            if (a->right == nullptr) {
+                a->right = b;
+                break;
+            }
+            if (b->value < a->right->value) {
+                swap(a->right, b);
+            }
+            a = a->right;
+        }
+
+        // Restore the leftist property bottom-up along the merge path
+        for (int i = length - 1; i >= 0; i--) {
+            Node* node = path[i];
+            if (rankOf(node->left) < rankOf(node->right)) {
+                swap(node->left, node->right);
+            }
+            node->rank = rankOf(node->right) + 1;
+        }
+
+        return result;
+    }
+
+    // Function to release every node of a subtree back to the arena, rotating left
+    // children up so the walk needs neither recursion nor a stack
+    void releaseAll(Node* node) {
+        while (node != nullptr) {
+            if (node->left == nullptr) {
+                Node* next = node->right;
+                arena->release(node);
+                node = next;
+            } else {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            }
+        }
+    }
+
+public:
+    // Constructor for a heap with its own arena
+    LeftistHeap() {
+        arena = new NodeArena<T>();
+        ownsArena = true;
+    }
+
+    // Constructor for a heap sharing an arena with other heaps it will be melded with
+    LeftistHeap(NodeArena<T>& sharedArena) {
+        arena = &sharedArena;
+        ownsArena = false;
+    }
+
+    // Destructor to return the nodes and, if owned, the arena
+    ~LeftistHeap() {
+        if (ownsArena) {
+            delete arena;
+        } else {
+            releaseAll(root);
+        }
+    }
+
+    LeftistHeap(const LeftistHeap&) = delete;
+    LeftistHeap& operator=(const LeftistHeap&) = delete;
+
+    // Public function to add an element to the heap
+    void add(T element) {
+        root = merge(root, arena->allocate(element));
+        size++;
+    }
+
+    // Public function to get the minimum element (top of the heap)
+    T peek() {
+        if (root == nullptr) {
+            throw out_of_range("Heap is empty");
+        }
+        return root->value;
+    }
+
+    // Public function to extract the minimum element from the heap
+    T extractMin() {
+        T min = peek();
+        Node* old = root;
+        root = merge(root->left, root->right);
+        arena->release(old);
+        size--;
+        return min;
+    }
+
+    /**
+     * Melds another heap into this one in O(log n); the other heap is left empty.
+     * Both heaps must allocate from the same arena.
+     *
+     * @param other The heap to meld into this one.
+     */
+    void meld(LeftistHeap& other) {
+        if (&other == this) {
+            return;
+        }
+        if (other.arena != arena) {
+            throw invalid_argument("Heaps must share an arena to be melded");
+        }
+        root = merge(root, other.root);
+        size += other.size;
+        other.root = nullptr;
+        other.size = 0;
+    }
+
+    // Public function to get the size of the heap
+    int heapSize() {
+        return size;
+    }
+
+    // Public function to check if the heap is empty
+    bool isEmpty() {
+        return (size == 0);
+    }
+
+    // Public function to clear the heap
+    void clear() {
+        releaseAll(root);
+        root = nullptr;
+        size = 0;
+    }
+};
+
+int main() {
+    // Test case 1: Add, peek and extract
+    LeftistHeap<int> heap1;
+    heap1.add(10);
+    heap1.add(5);
+    heap1.add(15);
+    assert(heap1.peek() == 5);
+    assert(heap1.extractMin() == 5);
+    assert(heap1.extractMin() == 10);
+    assert(heap1.heapSize() == 1);
+
+    // Test case 2: Meld two heaps sharing an arena
+    NodeArena<int> arena;
+    LeftistHeap<int> left(arena), right(arena);
+    for (int i = 0; i < 1000; i += 2) {
+        left.add(i);
+        right.add(i + 1);
+    }
+    left.meld(right);
+    assert(right.isEmpty());
+    assert(left.heapSize() == 1000);
+    for (int i = 0; i < 1000; i++) {
+        assert(left.extractMin() == i);
+    }
+    assert(left.isEmpty());
+
+    // Test case 3: Melding heaps with different arenas is rejected
+    bool thrown = false;
+    try {
+        heap1.meld(left);
+    } catch (invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Test case 4: Many partitions coalesced pairwise, nodes recycled through the arena
+    const int partitions = 64;
+    LeftistHeap<int>* parts[partitions];
+    unsigned int seed = 1;
+    for (int p = 0; p < partitions; p++) {
+        parts[p] = new LeftistHeap<int>(arena);
+        for (int i = 0; i < 500; i++) {
+            seed = seed * 1103515245u + 12345u;
+            parts[p]->add((seed >> 8) % 100000);
+        }
+    }
+    for (int step = 1; step < partitions; step *= 2) {
+        for (int p = 0; p + step < partitions; p += 2 * step) {
+            parts[p]->meld(*parts[p + step]);
+        }
+    }
+    assert(parts[0]->heapSize() == partitions * 500);
+    int previous = -1;
+    while (!parts[0]->isEmpty()) {
+        int top = parts[0]->extractMin();
+        assert(top >= previous);
+        previous = top;
+    }
+    for (int p = 0; p < partitions; p++) {
+        delete parts[p];
+    }
+
+    // Test case 5: Descending inserts build a long left spine without recursion
+    LeftistHeap<int> heap2;
+    for (int i = 0; i < 200000; i++) {
+        heap2.add(200000 - i);
+    }
+    assert(heap2.peek() == 1);
+    heap2.clear();
+    assert(heap2.isEmpty());
+
+    cout << "All test cases passed!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,339 @@
+/*
+    Author: Seif Ibrahim
+    Description: Min-Max Heap Data Strcture implementation
+                 (double-ended priority queue in one implicit array)
+
+    Last Updated: 19/10/2026
+
+    Github: Seif-Ibrahim1
+
+*/
+
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <cassert>
+
+using namespace std;
+
+// Which end a bounded heap drops when it is full
+enum EvictPolicy {
+    EVICT_MIN,      // Keep the largest elements (top-k)
+    EVICT_MAX       // Keep the smallest elements (bottom-k)
+};
+
+// MinMaxHeap class: even levels are min levels, odd levels are max levels.
+// The minimum is at index 0 and the maximum is one of its two children.
+template <typename T>
+class MinMaxHeap {
+    T* heap;                // Dynamic array to store the heap elements
+    int size = 0;           // Current number of elements in the heap
+    int cap;                // Current capacity of the array
+    int bound;              // Maximum number of elements kept (0 = unbounded)
+    EvictPolicy policy;     // End to evict from when the heap is bounded and full
+
+    // Function to check if index i is on a min level
+    bool isMinLevel(int i) {
+        return ((31 - __builtin_clz(i + 1)) & 1) == 0;
+    }
+
+    // Function to compare two elements in the order of a level (a before b)
+    bool before(const T& a, const T& b, bool minLevel) {
+        return minLevel ? a < b : b < a;
+    }
+
+    // Function to double the capacity of the array
+    void resize() {
+        cap *= 2;
+        T* newHeap = new T[cap];
+        for (int i = 0; i < size; i++) {
+            newHeap[i] = heap[i];
+        }
+        delete[] heap;
+        heap = newHeap;
+    }
+
+    // Function to move the element at index i up through the grandparents of its own level kind
+    void bubbleUpLevel(int i, bool minLevel) {
+        while (i >= 3) {
+            int grandparent = ((i - 1) / 2 - 1) / 2;
+            if (!before(heap[i], heap[grandparent], minLevel)) {
+                break;
+            }
+            swap(heap[i], heap[grandparent]);
+            i = grandparent;
+        }
+    }
+
+    // Function to restore the heap property for the element at index i towards the root
+    void bubbleUp(int i) {
+        if (i == 0) {
+            return;
+        }
+
+        bool minLevel = isMinLevel(i);
+        int parent = (i - 1) / 2;
+        if (before(heap[parent], heap[i], minLevel)) {
+            // The element belongs to the other kind of level
+            swap(heap[i], heap[parent]);
+            bubbleUpLevel(parent, !minLevel);
+        } else {
+            bubbleUpLevel(i, minLevel);
+        }
+    }
+
+    // Function to restore the heap property for the element at index i towards the leaves
+    void trickleDown(int i) {
+        bool minLevel = isMinLevel(i);
+        while (true) {
+            // Find the best element among the children and grandchildren of i
+            int m = -1;
+            int firstChild = 2 * i + 1;
+            for (int c = firstChild; c < firstChild + 2 && c < size; c++) {
+                if (m == -1 || before(heap[c], heap[m], minLevel)) {
+                    m = c;
+                }
+                for (int g = 2 * c + 1; g < 2 * c + 3 && g < size; g++) {
+                    if (before(heap[g], heap[m], minLevel)) {
+                        m = g;
+                    }
+                }
+            }
+
+            if (m == -1 || !before(heap[m], heap[i], minLevel)) {
+                return;
+            }
+
+            swap(heap[m], heap[i]);
+            if (m <= firstChild + 1) {
+                return; // m is a child, so it has no descendants on the current level kind
+            }
+
+            int parent = (m - 1) / 2;
+            if (before(heap[parent], heap[m], minLevel)) {
+                swap(heap[m], heap[parent]);
+            }
+            i = m;
+        }
+    }
+
+    // Function to restore the heap property after the element at index i was overwritten
+    void fix(int i) {
+        bool minLevel = isMinLevel(i);
+        if (i > 0 && before(heap[(i - 1) / 2], heap[i], minLevel)) {
+            int parent = (i - 1) / 2;
+            swap(heap[i], heap[parent]);
+            trickleDown(i);
+            bubbleUpLevel(parent, !minLevel);
+        } else {
+            bubbleUpLevel(i, minLevel);
+            trickleDown(i);
+        }
+    }
+
+    // Function to remove the element at index i
+    void removeAt(int i) {
+        heap[i] = heap[--size];
+        if (i < size) {
+            fix(i);
+        }
+    }
+
+    // Function to get the index of the maximum element
+    int maxIndex() {
+        if (size == 1) {
+            return 0;
+        }
+        if (size == 2 || heap[2] < heap[1]) {
+            return 1;
+        }
+        return 2;
+    }
+
+public:
+    // Constructor for the MinMaxHeap class; a non-zero bound keeps at most bound elements
+    MinMaxHeap(int _bound = 0, EvictPolicy _policy = EVICT_MIN) {
+        bound = max(0, _bound);
+        policy = _policy;
+        cap = max(2, bound);
+        heap = new T[cap];
+    }
+
+    // Destructor to deallocate memory
+    ~MinMaxHeap() {
+        delete[] heap;
+    }
+
+    MinMaxHeap(const MinMaxHeap&) = delete;
+    MinMaxHeap& operator=(const MinMaxHeap&) = delete;
+
+    /**
+     * Adds an element to the heap. When the heap is bounded and full, the element replaces
+     * the end named by the evict policy, or is rejected if it would be evicted itself.
+     *
+     * @param element The element to add.
+     * @return true if the element was kept, false if it was rejected.
+     */
+    bool add(T element) {
+        if (bound == 0 || size < bound) {
+            if (size >= cap) {
+                resize();
+            }
+            heap[size] = element;
+            bubbleUp(size++);
+            return true;
+        }
+
+        if (policy == EVICT_MIN) {
+            if (!(heap[0] < element)) {
+                return false;
+            }
+            heap[0] = element;
+            fix(0);
+        } else {
+            int i = maxIndex();
+            if (!(element < heap[i])) {
+                return false;
+            }
+            heap[i] = element;
+            fix(i);
+        }
+        return true;
+    }
+
+    // Public function to get the minimum element
+    T peekMin() {
+        if (size == 0) {
+            throw out_of_range("Heap is empty");
+        }
+        return heap[0];
+    }
+
+    // Public function to get the maximum element
+    T peekMax() {
+        if (size == 0) {
+            throw out_of_range("Heap is empty");
+        }
+        return heap[maxIndex()];
+    }
+
+    // Public function to extract the minimum element
+    T extractMin() {
+        T min = peekMin();
+        removeAt(0);
+        return min;
+    }
+
+    // Public function to extract the maximum element
+    T extractMax() {
+        T max = peekMax();
+        removeAt(maxIndex());
+        return max;
+    }
+
+    // Public function to get the size of the heap
+    int heapSize() {
+        return size;
+    }
+
+    // Public function to check if the heap is empty
+    bool isEmpty() {
+        return (size == 0);
+    }
+
+    // Public function to check if a bounded heap is full
+    bool isFull() {
+        return bound != 0 && size == bound;
+    }
+
+    // Public function to clear the heap
+    void clear() {
+        size = 0;
+    }
+};
+
+int main() {
+    // Test case 1: Both extremes are available
+    MinMaxHeap<int> heap1;
+    heap1.add(10);
+    assert(heap1.peekMin() == 10 && heap1.peekMax() == 10);
+    heap1.add(5);
+    heap1.add(15);
+    heap1.add(7);
+    heap1.add(30);
+    assert(heap1.heapSize() == 5);
+    assert(heap1.peekMin() == 5);
+    assert(heap1.peekMax() == 30);
+
+    // Test case 2: Extract from both ends
+    assert(heap1.extractMax() == 30);
+    assert(heap1.extractMin() == 5);
+    assert(heap1.extractMax() == 15);
+    assert(heap1.extractMin() == 7);
+    assert(heap1.extractMin() == 10);
+    assert(heap1.isEmpty());
+
+    // Test case 3: Random operations match a multiset
+    MinMaxHeap<int> heap2;
+    multiset<int> reference;
+    unsigned int seed = 42;
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int op = (seed >> 16) % 4;
+        if (op < 2 || reference.empty()) {
+            int value = (seed >> 4) % 1000;
+            heap2.add(value);
+            reference.insert(value);
+        } else if (op == 2) {
+            assert(heap2.extractMin() == *reference.begin());
+            reference.erase(reference.begin());
+        } else {
+            assert(heap2.extractMax() == *reference.rbegin());
+            reference.erase(prev(reference.end()));
+        }
+        assert(heap2.heapSize() == (int) reference.size());
+        if (!reference.empty()) {
+            assert(heap2.peekMin() == *reference.begin());
+            assert(heap2.peekMax() == *reference.rbegin());
+        }
+    }
+
+    // Test case 4: Bounded top-k evicts the minimum
+    MinMaxHeap<int> top3(3, EVICT_MIN);
+    int stream[] = { 4, 9, 1, 7, 3, 8, 2 };
+    for (int value : stream) {
+        top3.add(value);
+    }
+    assert(top3.isFull());
+    assert(!top3.add(5));
+    assert(top3.peekMin() == 7 && top3.peekMax() == 9);
+
+    // Test case 5: Bounded bottom-k evicts the maximum
+    MinMaxHeap<int> bottom3(3, EVICT_MAX);
+    for (int value : stream) {
+        bottom3.add(value);
+    }
+    assert(bottom3.peekMin() == 1 && bottom3.peekMax() == 3);
+    assert(bottom3.extractMax() == 3);
+    assert(bottom3.extractMax() == 2);
+    assert(bottom3.extractMax() == 1);
+
+    // Test case 6: Bounded heap matches a sorted reference
+    MinMaxHeap<int> top50(50, EVICT_MIN);
+    multiset<int> best;
+    for (int i = 0; i < 5000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int value = (seed >> 8) % 100000;
+        top50.add(value);
+        best.insert(value);
+        if (best.size() > 50) {
+            best.erase(best.begin());
+        }
+        assert(top50.peekMin() == *best.begin());
+        assert(top50.peekMax() == *best.rbegin());
+    }
+
+    cout << "All test cases passed!" << endl;
+
+    return 0;
+}
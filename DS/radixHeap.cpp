@@ -0,0 +1,212 @@
+/*
+    Author: Seif Ibrahim
+    Description: Radix Heap Data Strcture implementation
+                 (monotone priority queue for unsigned integer keys)
+
+    Last Updated: 19/10/2026
+
+    Github: Seif-Ibrahim1
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <cassert>
+
+using namespace std;
+
+// RadixHeap class for monotone priority queues: every extracted key is >= the previous one.
+// Entries are bucketed by the highest bit in which they differ from the last extracted minimum,
+// so each entry moves down at most (number of key bits) times -> amortized O(log C) per operation.
+template <typename K, typename V = int>
+class RadixHeap {
+    static_assert(is_integral<K>::value && is_unsigned<K>::value, "RadixHeap keys must be unsigned integers");
+
+    static const int BUCKETS = numeric_limits<K>::digits + 1;
+
+    vector<pair<K, V>> buckets[BUCKETS];    // Bucket i holds keys whose highest differing bit from last is i - 1
+    K bucketMin[BUCKETS];                   // Smallest key currently stored in each bucket
+    K last = 0;                             // Last extracted minimum (lower bound of every stored key)
+    int size = 0;                           // Current number of elements in the heap
+
+    // Function to get the bucket index of a key relative to the last extracted minimum
+    int bucketOf(K key) {
+        K diff = key ^ last;
+        if (diff == 0) {
+            return 0;
+        }
+        return numeric_limits<unsigned long long>::digits - __builtin_clzll((unsigned long long) diff);
+    }
+
+    // Function to place an entry in its bucket and keep the bucket minimum up to date
+    void place(K key, const V& value) {
+        int b = bucketOf(key);
+        if (buckets[b].empty() || key < bucketMin[b]) {
+            bucketMin[b] = key;
+        }
+        buckets[b].emplace_back(key, value);
+    }
+
+    // Function to make sure bucket 0 holds the current minimum
+    void pull() {
+        if (!buckets[0].empty()) {
+            return;
+        }
+
+        int i = 1;
+        while (buckets[i].empty()) {
+            i++;
+        }
+
+        // Advance last to the smallest key in the first non-empty bucket and redistribute it;
+        // every entry lands in a strictly lower bucket
+        last = bucketMin[i];
+        vector<pair<K, V>> moved;
+        moved.swap(buckets[i]);
+        for (auto& entry : moved) {
+            place(entry.first, entry.second);
+        }
+
+        // Keep the vector's storage around for the next time this bucket fills up
+        moved.clear();
+        buckets[i].swap(moved);
+    }
+
+public:
+    // Constructor for the RadixHeap class
+    RadixHeap() = default;
+
+    // Public function to add a key (and an optional value) to the heap
+    void add(K key, V value = V()) {
+        if (key < last) {
+            throw invalid_argument("Key is smaller than the last extracted minimum");
+        }
+
+        place(key, value);
+        size++;
+    }
+
+    // Public function to get the minimum key (top of the heap)
+    K peek() {
+        if (isEmpty()) {
+            throw out_of_range("Heap is empty");
+        }
+
+        pull();
+        return last;
+    }
+
+    // Public function to get the value stored with the minimum key
+    V peekValue() {
+        if (isEmpty()) {
+            throw out_of_range("Heap is empty");
+        }
+
+        pull();
+        return buckets[0].back().second;
+    }
+
+    // Public function to extract the minimum key from the heap
+    K extractMin() {
+        if (isEmpty()) {
+            throw out_of_range("Heap is empty");
+        }
+
+        pull();
+        buckets[0].pop_back();
+        size--;
+        return last;
+    }
+
+    // Public function to get the last extracted minimum (the smallest key add() accepts)
+    K lastExtracted() {
+        return last;
+    }
+
+    // Public function to get the size of the heap
+    int heapSize() {
+        return size;
+    }
+
+    // Public function to check if the heap is empty
+    bool isEmpty() {
+        return (size == 0);
+    }
+
+    // Public function to clear the heap
+    void clear() {
+        for (int i = 0; i < BUCKETS; i++) {
+            buckets[i].clear();
+        }
+        last = 0;
+        size = 0;
+    }
+};
+
+int main() {
+    // Test case 1: Add elements and extract them in order
+    RadixHeap<unsigned int> heap1;
+    heap1.add(10);
+    heap1.add(5);
+    heap1.add(15);
+    heap1.add(5);
+    assert(heap1.heapSize() == 4);
+    assert(heap1.peek() == 5);
+    assert(heap1.extractMin() == 5);
+    assert(heap1.extractMin() == 5);
+    assert(heap1.extractMin() == 10);
+
+    // Test case 2: Keys added after an extraction must not be smaller than the last minimum
+    heap1.add(12);
+    heap1.add(10);
+    assert(heap1.peek() == 10);
+    bool thrown = false;
+    try {
+        heap1.add(9);
+    } catch (invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Test case 3: Values travel with their keys
+    RadixHeap<unsigned long long, char> heap2;
+    heap2.add(1000000000000ULL, 'c');
+    heap2.add(3, 'a');
+    heap2.add(70000, 'b');
+    assert(heap2.peekValue() == 'a');
+    assert(heap2.extractMin() == 3);
+    assert(heap2.peekValue() == 'b');
+    assert(heap2.extractMin() == 70000);
+    assert(heap2.peekValue() == 'c');
+    assert(heap2.extractMin() == 1000000000000ULL);
+    assert(heap2.isEmpty());
+
+    // Test case 4: Monotone workload (Dijkstra-like) matches a sorted order
+    RadixHeap<unsigned int> heap3;
+    unsigned int seed = 7, previous = 0;
+    for (int i = 0; i < 1000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        heap3.add(seed % 100000);
+    }
+    for (int i = 0; i < 5000; i++) {
+        unsigned int top = heap3.extractMin();
+        assert(top >= previous);
+        previous = top;
+        seed = seed * 1103515245u + 12345u;
+        heap3.add(top + seed % 1000);
+    }
+    assert(heap3.heapSize() == 1000);
+
+    // Test case 5: Clear the heap
+    heap3.clear();
+    assert(heap3.isEmpty());
+    heap3.add(0);
+    assert(heap3.peek() == 0);
+
+    cout << "All test cases passed!" << endl;
+
+    return 0;
+}